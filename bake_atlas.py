@@ -0,0 +1,154 @@
+"""Packs the game sprites into one texture page.
+
+Every sprite is resampled offline to each size it is drawn at, so the game
+loads a single small texture instead of full-resolution PNGs that get scaled
+down every frame. Writes assets/atlas/sprites.png and the rect table in
+include/SpriteAtlas.h. Run from the repository root after changing any image
+in assets/characters, assets/icons, assets/maps or the logo.
+"""
+from PIL import Image
+
+PAGE_PATH = 'assets/atlas/sprites.png'
+HEADER_PATH = 'include/SpriteAtlas.h'
+PADDING = 1  # Keeps neighbouring sprites from bleeding into each other when filtered
+
+CELL_SIZE = 40
+MAP_SIZE = 15 * CELL_SIZE
+ENEMY_HEIGHT = CELL_SIZE - 4  # Leaves room for the health bar under each enemy
+
+
+def stretch(width, height):
+    return lambda image: (width, height)
+
+
+def fit(size):
+    # Longer side becomes size, aspect ratio kept
+    def target(image):
+        scale = size / max(image.size)
+        return (round(image.width * scale), round(image.height * scale))
+    return target
+
+
+def fit_height_of(paths, height):
+    # One scale for a group of images so they keep their relative sizes
+    def target(image):
+        tallest = max(Image.open(path).height for path in paths)
+        scale = height / tallest
+        return (round(image.width * scale), round(image.height * scale))
+    return target
+
+
+ENEMIES = ['assets/characters/monster.png', 'assets/characters/boss.png']
+
+# name, source image, size it is drawn at
+SPRITES = [
+    ('MAP_BACKGROUND',  'assets/maps/prison.png',        stretch(MAP_SIZE, MAP_SIZE)),
+    ('MAP_WALL',        'assets/maps/wall.png',          stretch(CELL_SIZE, CELL_SIZE)),
+    ('MAP_KNIGHT',      'assets/characters/knight.png',  stretch(CELL_SIZE, CELL_SIZE)),
+    ('MAP_MAGE',        'assets/characters/mage.png',    stretch(CELL_SIZE, CELL_SIZE)),
+    ('MAP_ARCHER',      'assets/characters/archer.png',  stretch(CELL_SIZE, CELL_SIZE)),
+    ('MAP_MONSTER',     'assets/characters/monster.png', fit_height_of(ENEMIES, ENEMY_HEIGHT)),
+    ('MAP_BOSS',        'assets/characters/boss.png',    fit_height_of(ENEMIES, ENEMY_HEIGHT)),
+    ('MAP_ITEM',        'assets/characters/item.png',    fit(CELL_SIZE)),
+    ('PORTRAIT_KNIGHT', 'assets/characters/knight.png',  fit(250)),
+    ('PORTRAIT_MAGE',   'assets/characters/mage.png',    fit(250)),
+    ('PORTRAIT_ARCHER', 'assets/characters/archer.png',  fit(250)),
+    ('ICON_SWORD',      'assets/icons/sword.png',        fit(48)),
+    ('ICON_HAT',        'assets/icons/hat.png',          fit(48)),
+    ('ICON_BOW',        'assets/icons/bow.png',          fit(48)),
+    ('HUD_SWORD',       'assets/icons/sword.png',        fit(32)),
+    ('HUD_HAT',         'assets/icons/hat.png',          fit(32)),
+    ('HUD_BOW',         'assets/icons/bow.png',          fit(32)),
+    ('DICE',            'assets/icons/dice.png',         fit(60)),
+    ('LOGO',            'assets/logo.png',               stretch(300, 300)),
+]
+
+
+def load_sprites():
+    sprites = []
+    for name, path, target in SPRITES:
+        image = Image.open(path).convert('RGBA')
+        size = target(image)
+        if size != image.size:
+            image = image.resize(size, Image.LANCZOS)
+        sprites.append((name, image))
+
+    # Solid white block; the game samples its centre texel for bars and lines
+    sprites.append(('SOLID', Image.new('RGBA', (3, 3), (255, 255, 255, 255))))
+    return sprites
+
+
+def pack(sprites):
+    # Shelf packing: tallest first, rows filled left to right
+    area = sum((image.width + PADDING) * (image.height + PADDING) for _, image in sprites)
+    widest = max(image.width + PADDING for _, image in sprites)
+    width = 64
+    while width < widest or width * width < area:
+        width *= 2
+
+    positions = {}
+    x = y = shelf_height = 0
+    for name, image in sorted(sprites, key=lambda sprite: -sprite[1].height):
+        if x + image.width > width:
+            x = 0
+            y += shelf_height + PADDING
+            shelf_height = 0
+        positions[name] = (x, y)
+        x += image.width + PADDING
+        shelf_height = max(shelf_height, image.height)
+
+    return width, y + shelf_height, positions
+
+
+def write_header(width, height, sprites, positions):
+    lines = [
+        '// Generated by bake_atlas.py, do not edit.',
+        '#pragma once',
+        '',
+        'namespace SpriteAtlas {',
+        '',
+        'constexpr const char* PAGE_PATH = "%s";' % PAGE_PATH,
+        'constexpr unsigned PAGE_WIDTH = %d;' % width,
+        'constexpr unsigned PAGE_HEIGHT = %d;' % height,
+        '',
+        'enum class Sprite {',
+    ]
+    lines += ['    %s,' % name for name, _ in sprites]
+    lines += [
+        '    COUNT',
+        '};',
+        '',
+        'struct Rect {',
+        '    int left;',
+        '    int top;',
+        '    int width;',
+        '    int height;',
+        '};',
+        '',
+        'constexpr Rect RECTS[] = {',
+    ]
+    for name, image in sprites:
+        x, y = positions[name]
+        lines.append('    {%d, %d, %d, %d},  // %s' % (x, y, image.width, image.height, name))
+    lines += [
+        '};',
+        '',
+        'constexpr const Rect& GetRect(Sprite sprite) { return RECTS[static_cast<int>(sprite)]; }',
+        '',
+        '}  // namespace SpriteAtlas',
+        '',
+    ]
+    with open(HEADER_PATH, 'w') as header:
+        header.write('\n'.join(lines))
+
+
+sprites = load_sprites()
+width, height, positions = pack(sprites)
+
+page = Image.new('RGBA', (width, height), (0, 0, 0, 0))
+for name, image in sprites:
+    page.paste(image, positions[name])
+page.save(PAGE_PATH, optimize=True)
+
+write_header(width, height, sprites, positions)
+print('Packed %d sprites into a %dx%d page' % (len(sprites), width, height))
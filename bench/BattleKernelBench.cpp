@@ -0,0 +1,78 @@
+#include "BattleKernel.h"
+#include "GameLogic.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+
+namespace {
+
+// Swallows Logger output so the per-fight path is measured without terminal I/O
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+Character MakeKnight() { return Character("Knight", 120, 25, 25, 12, 8); }
+Character MakeMonster() { return Character("Monster", 80, 25, 15, 15, 10); }
+
+double BattlesPerSecond(size_t battles, double seconds) {
+    return seconds > 0.0 ? battles / seconds : 0.0;
+}
+
+double RunKernel(size_t battles, BattleKernel::Path path) {
+    Character knight = MakeKnight();
+    Character monster = MakeMonster();
+    BattleBatch batch;
+    batch.Resize(battles);
+    for (size_t i = 0; i < battles; ++i) {
+        batch.SetLane(i, knight, monster, static_cast<uint32_t>(i * 2654435761u + 1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BattleKernel::Resolve(batch, 1000, path);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return BattlesPerSecond(battles, elapsed.count());
+}
+
+double RunCharacterPath(size_t battles) {
+    NullBuffer nullBuffer;
+    std::streambuf* previous = std::cout.rdbuf(&nullBuffer);
+
+    Pcg32 rng(1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < battles; ++i) {
+        Character knight = MakeKnight();
+        Character monster = MakeMonster();
+        bool knightTurn = knight.GetSpeed() > monster.GetSpeed();
+        while (!knight.IsDefeated() && !monster.IsDefeated()) {
+            if (knightTurn) {
+                monster.TakeDamage(knight.GetTotalAttack(), rng);
+            } else {
+                knight.TakeDamage(monster.GetTotalAttack(), rng);
+            }
+            knightTurn = !knightTurn;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.rdbuf(previous);
+    return BattlesPerSecond(battles, elapsed.count());
+}
+
+}  // namespace
+
+int main() {
+    const size_t kernelBattles = 1 << 20;
+    const size_t characterBattles = 1 << 14;
+
+    std::printf("Battles per second (single core)\n");
+    std::printf("  Character::TakeDamage : %14.0f\n", RunCharacterPath(characterBattles));
+    std::printf("  kernel, scalar        : %14.0f\n", RunKernel(kernelBattles, BattleKernel::Path::SCALAR));
+    if (BattleKernel::HasAvx2()) {
+        std::printf("  kernel, AVX2          : %14.0f\n", RunKernel(kernelBattles, BattleKernel::Path::AUTO));
+    } else {
+        std::printf("  kernel, AVX2          : not supported on this CPU\n");
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts calls to the global operator new made by the calling thread, to check
+// that a steady frame does not allocate on the render thread. Only builds with FIGHTGPT_COUNT_ALLOCATIONS replace operator
+// new; otherwise the count stays at zero and the check compiles away.
+class AllocationCounter {
+public:
+#ifdef FIGHTGPT_COUNT_ALLOCATIONS
+    static const bool ENABLED = true;
+#else
+    static const bool ENABLED = false;
+#endif
+
+    static uint64_t GetCount();  // The calling thread's allocations so far
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Read-only view of the archive written by pack_assets.py. The file is
+// memory-mapped once and stays mapped, so payloads are used in place: fonts
+// read glyphs straight from the mapping and textures upload their RGBA
+// pixels without a decode or a copy.
+class AssetArchive {
+public:
+    static constexpr const char* DEFAULT_PATH = "assets.pak";
+
+    enum class Kind : uint32_t {
+        RAW = 0,   // File contents as they were
+        RGBA = 1,  // Decoded pixels, width * height * 4 bytes
+    };
+
+    struct Entry {
+        Kind kind;
+        uint32_t width;
+        uint32_t height;
+        const uint8_t* data;
+        size_t size;
+    };
+
+    bool open(const std::string& path);  // False if missing or malformed; logs the latter
+    bool isOpen() const { return file.isOpen(); }
+    const Entry* find(const std::string& name) const;  // Null if not packed
+
+private:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t NAME_SIZE = 96;
+
+    bool readTable();
+
+    MappedFile file;
+    std::unordered_map<std::string, Entry> entries;
+};
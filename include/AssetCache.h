@@ -0,0 +1,66 @@
+#pragma once
+
+#include "AssetArchive.h"
+#include <SFML/Graphics.hpp>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fonts and textures shared by every state, keyed by path. Each file is read
+// and uploaded once per process: handles are reference counted and the cache
+// holds one of its own, so a state transition finds the assets the previous
+// state used still in place. releaseUnused() frees what no state holds any
+// more. Render thread only, like the textures themselves.
+//
+// preload*() reads and decodes files on worker threads in parallel while the
+// current screen keeps drawing; update() then does only the GPU upload, one
+// texture per frame. Asking for an asset still being decoded waits for it.
+//
+// Assets packed into assets.pak by pack_assets.py are taken from the mapped
+// archive instead, with no file to open and no decode, and are never preloaded.
+// FIGHTGPT_LOOSE_ASSETS=1 ignores the archive, to compare against loose files.
+class AssetCache {
+public:
+    static constexpr const char* DEFAULT_FONT_PATH = "assets/fonts/Jersey15-Regular.ttf";
+
+    static AssetCache& Instance();
+
+    // Never null. A file that fails to load is reported once and cached empty,
+    // which draws nothing, so a missing asset does not hit the disk every transition.
+    std::shared_ptr<const sf::Font> getFont(const std::string& path);
+    std::shared_ptr<const sf::Texture> getTexture(const std::string& path);
+
+    void preloadFont(const std::string& path);
+    void preloadTexture(const std::string& path);
+    void update();  // Once per frame: takes finished decodes and uploads them
+
+    bool isLoading() const { return !pendingFonts.empty() || !pendingTextures.empty(); }
+    bool isTextureReady(const std::string& path) const;
+    bool isPacked() const { return archive.isOpen(); }
+    float getProgress() const;  // Preloads finished out of those requested since the loader was last idle
+
+    size_t releaseUnused();  // Drops assets only the cache still holds; returns how many
+
+private:
+    AssetCache();
+
+    template <typename Asset>
+    using AssetMap = std::unordered_map<std::string, std::shared_ptr<Asset>>;
+
+    template <typename Asset>
+    static size_t releaseUnused(AssetMap<Asset>& assets);
+    void startPreload();
+    void finishPreload();
+
+    AssetArchive archive;
+    AssetMap<sf::Font> fonts;
+    AssetMap<sf::Texture> textures;
+
+    // Worker results: a font's file contents, or a decoded image (null if unreadable)
+    std::unordered_map<std::string, std::future<std::vector<char>>> pendingFonts;
+    std::unordered_map<std::string, std::future<std::unique_ptr<sf::Image>>> pendingTextures;
+    size_t preloadsRequested = 0;
+    size_t preloadsFinished = 0;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Character;
+
+// Struct-of-arrays batch of independent duels. Lane i pits side A[i] against
+// side B[i] using the same damage rules as Character::TakeDamage, so balance
+// sweeps can resolve thousands of fights without touching Character or Logger.
+struct BattleBatch {
+    static const size_t LANE_WIDTH = 8;  // One AVX2 register of int32 lanes
+
+    std::vector<int32_t> healthA;
+    std::vector<int32_t> attackA;
+    std::vector<int32_t> defenseA;
+    std::vector<int32_t> avoidanceA;
+    std::vector<int32_t> healthB;
+    std::vector<int32_t> attackB;
+    std::vector<int32_t> defenseB;
+    std::vector<int32_t> avoidanceB;
+    std::vector<int32_t> turnA;      // 1 when side A strikes next, 0 for side B
+    std::vector<int32_t> finished;   // 1 once either side is defeated
+    std::vector<int32_t> rounds;     // Attacks resolved so far in this lane
+    std::vector<uint32_t> rngState;  // Per-lane xorshift32 state, never 0
+
+    // Resizes to hold n battles. Storage is padded to a multiple of LANE_WIDTH
+    // and the padding lanes start out finished so they never do any work.
+    void Resize(size_t n);
+    size_t Size() const { return count; }
+
+    void SetLane(size_t lane, Character& a, Character& b, uint32_t seed);
+    bool IsFinished(size_t lane) const { return finished[lane] != 0; }
+    bool WinnerIsA(size_t lane) const { return healthB[lane] <= 0; }
+
+private:
+    size_t count = 0;
+};
+
+class BattleKernel {
+public:
+    enum class Path {
+        AUTO,    // AVX2 when the CPU supports it, scalar otherwise
+        SCALAR
+    };
+
+    // Resolves one attack in every unfinished lane. Returns the number of
+    // lanes still running afterwards.
+    static size_t Step(BattleBatch& batch, Path path = Path::AUTO);
+
+    // Steps until every lane has finished or maxRounds attacks were made.
+    static void Resolve(BattleBatch& batch, int maxRounds = 1000, Path path = Path::AUTO);
+
+    static bool HasAvx2();
+};
@@ -3,6 +3,7 @@
 #include "GameState.h"
 #include "StoryState.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <array>
 #include <string>
 
@@ -19,16 +20,15 @@ private:
     void updatePositions();
 
     // Text elements
-    sf::Font font;
+    std::shared_ptr<const sf::Font> font;
     sf::Text title;
     std::array<sf::Text, 3> options;
     sf::Text logText;
+    sf::Text instructionText;
 
     // Visual elements
     std::array<sf::RectangleShape, 3> optionBoxes;
-    std::array<sf::Texture, 3> classIcons;
     std::array<sf::Sprite, 3> iconSprites;
-    std::array<sf::Texture, 3> characterTextures;
     std::array<sf::Sprite, 3> characterSprites;
     sf::RectangleShape logPanel;
 
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "TextWrapper.h"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Who or what produced a log line; decides the row highlight color
+enum class LogCategory {
+    NORMAL,         // Plain status text, no highlight
+    PLAYER_ACTION,  // Player attacks, heals, abilities, successful escapes
+    ENEMY_ACTION,   // Enemy attacks and negative events for the player
+    PROMPT,         // Keyboard options the player can choose from
+    DISCOVERY       // Found items, battle start and end
+};
+
+// Fixed ring of rendered log rows, newest on top. Adding a line only rebuilds
+// that line's text and background; rows are placed with a per-row transform
+// at draw time, so older entries are never touched again. Lines wider than
+// the panel wrap onto further rows.
+class CombatLog : public sf::Drawable {
+public:
+    static const size_t MAX_LINES = 25;
+
+    CombatLog();
+
+    void setLayout(const sf::Font& font, const sf::Vector2f& position, float width);
+    void add(LogCategory category, const std::string& message);  // Splits on newlines and wraps, skips empty lines
+    void clear();
+
+private:
+    struct Entry {
+        sf::Text text;
+        sf::RectangleShape background;
+        bool highlighted = false;
+    };
+
+    void addLine(LogCategory category, std::string_view line);
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    static sf::Color categoryColor(LogCategory category);
+
+    std::array<Entry, MAX_LINES> entries;
+    size_t newest;
+    size_t count;
+    const sf::Font* font;
+    sf::Vector2f position;
+    float width;
+    TextWrapper wrapper;
+    std::vector<std::string_view> lines;  // Reused by add()
+};
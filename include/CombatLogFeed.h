@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CombatLog.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Log messages as the simulation produces them, before they are laid out.
+// Every message gets the next sequence number and the newest CAPACITY are
+// kept, so a copy of the feed tells the reader exactly which messages it has
+// not shown yet. Clearing only moves the start of the visible range.
+class CombatLogFeed {
+public:
+    static const size_t CAPACITY = CombatLog::MAX_LINES;
+
+    struct Message {
+        LogCategory category = LogCategory::NORMAL;
+        std::string text;
+    };
+
+    void add(LogCategory category, const std::string& text) {
+        Message& message = messages[nextSequence % CAPACITY];
+        message.category = category;
+        message.text = text;
+        ++nextSequence;
+    }
+    void clear() { clearedSequence = nextSequence; }
+
+    uint64_t getNextSequence() const { return nextSequence; }
+    uint64_t getClearedSequence() const { return clearedSequence; }
+
+    // Calls visit(message) for each kept message from sequence `from` on, oldest first
+    template <typename Visitor>
+    void forEachSince(uint64_t from, Visitor&& visit) const {
+        uint64_t first = std::max(from, clearedSequence);
+        if (nextSequence > CAPACITY) first = std::max(first, nextSequence - CAPACITY);
+        for (uint64_t sequence = first; sequence < nextSequence; ++sequence) {
+            visit(messages[sequence % CAPACITY]);
+        }
+    }
+
+private:
+    std::array<Message, CAPACITY> messages;
+    uint64_t nextSequence = 0;
+    uint64_t clearedSequence = 0;
+};
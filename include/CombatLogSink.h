@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CombatLogFeed.h"
+#include "GameEvents.h"
+#include <string>
+
+// Turns gameplay events into combat log lines and mirrors them to the log file.
+class CombatLogSink {
+public:
+    explicit CombatLogSink(CombatLogFeed& log) : log(log) {}
+
+    void subscribe(GameEventBus& bus);
+
+private:
+    void onCharacterCreated(const CharacterCreated& event);
+    void onPlayerMoved(const PlayerMoved& event);
+    void onBattleStart(const BattleStart& event);
+    void onCombatPrompt(const CombatPrompt& event);
+    void onEnemyTurnStarted(const EnemyTurnStarted& event);
+    void onDiceRolled(const DiceRolled& event);
+    void onEscapeAttempted(const EscapeAttempted& event);
+    void onDamageDealt(const DamageDealt& event);
+    void onDodged(const Dodged& event);
+    void onStatusDamage(const StatusDamage& event);
+    void onBattleEnd(const BattleEnd& event);
+    void onLevelUp(const LevelUp& event);
+    void onItemFound(const ItemFound& event);
+    void onItemPicked(const ItemPicked& event);
+    void onItemLeft(const ItemLeft& event);
+    void onItemUsed(const ItemUsed& event);
+    void onInventoryShown(const InventoryShown& event);
+    void onAbilityUsed(const AbilityUsed& event);
+    void onSaveFinished(const SaveFinished& event);
+    void onTurnsRewound(const TurnsRewound& event);
+
+    void write(LogCategory category, const std::string& message);
+
+    CombatLogFeed& log;
+};
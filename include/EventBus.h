@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <variant>
+
+// Typed publish/subscribe without heap use. Published events are copied into a
+// fixed ring and delivered in publish order to a fixed table of subscribers
+// per event type. Handlers may publish; those events are queued behind the one
+// being delivered. Pointers inside events are only valid during delivery.
+template <typename... Events>
+class EventBus {
+public:
+    static const size_t QUEUE_CAPACITY = 64;
+    static const size_t MAX_SUBSCRIBERS = 8;
+
+    EventBus() : head(0), pending(0), dispatching(false), dropped(0) {}
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Returns false when the event type already has MAX_SUBSCRIBERS
+    template <typename Event, typename Owner, void (Owner::*Handler)(const Event&)>
+    bool subscribe(Owner* owner) {
+        Subscribers<Event>& list = std::get<Subscribers<Event>>(subscribers);
+        if (list.count == MAX_SUBSCRIBERS) return false;
+        list.entries[list.count++] = {owner, [](void* target, const Event& event) {
+            (static_cast<Owner*>(target)->*Handler)(event);
+        }};
+        return true;
+    }
+
+    // Removes every handler registered for owner, across all event types
+    void unsubscribe(const void* owner) {
+        (std::get<Subscribers<Events>>(subscribers).remove(owner), ...);
+    }
+
+    template <typename Event>
+    void publish(const Event& event) {
+        if (pending == QUEUE_CAPACITY) {
+            ++dropped;
+            return;
+        }
+        queue[(head + pending) % QUEUE_CAPACITY] = event;
+        ++pending;
+
+        if (dispatching) return;  // The outer publish delivers it in order
+        dispatching = true;
+        while (pending > 0) {
+            std::visit([this](const auto& queued) { deliver(queued); }, queue[head]);
+            head = (head + 1) % QUEUE_CAPACITY;
+            --pending;
+        }
+        dispatching = false;
+    }
+
+    size_t getDroppedCount() const { return dropped; }
+
+private:
+    template <typename Event>
+    struct Subscribers {
+        struct Entry {
+            void* owner;
+            void (*handler)(void* owner, const Event& event);
+        };
+
+        void remove(const void* owner) {
+            size_t kept = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (entries[i].owner != owner) entries[kept++] = entries[i];
+            }
+            count = kept;
+        }
+
+        std::array<Entry, MAX_SUBSCRIBERS> entries{};
+        size_t count = 0;
+    };
+
+    template <typename Event>
+    void deliver(const Event& event) {
+        const Subscribers<Event>& list = std::get<Subscribers<Event>>(subscribers);
+        for (size_t i = 0; i < list.count; ++i) {
+            list.entries[i].handler(list.entries[i].owner, event);
+        }
+    }
+
+    std::tuple<Subscribers<Events>...> subscribers;
+    std::array<std::variant<Events...>, QUEUE_CAPACITY> queue;
+    size_t head;
+    size_t pending;
+    bool dispatching;
+    size_t dropped;
+};
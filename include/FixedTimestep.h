@@ -0,0 +1,31 @@
+#pragma once
+
+// Turns elapsed wall-clock time into a whole number of fixed simulation steps,
+// so timers and animations advance the same way whatever the frame rate. Time
+// short of a full step carries over to the next frame and is exposed as the
+// interpolation factor between the last two steps. After a stall at most
+// MAX_CATCH_UP_STEPS are run and the rest of the backlog is dropped, so slow
+// steps cannot snowball into ever longer frames.
+class FixedTimestep {
+public:
+    static constexpr int DEFAULT_RATE = 60;  // Steps per second
+    static constexpr int MIN_RATE = 10;
+    static constexpr int MAX_RATE = 1000;
+    static constexpr int MAX_CATCH_UP_STEPS = 5;
+
+    explicit FixedTimestep(int rate = configuredRate());
+
+    int advance(float elapsedSeconds);  // Number of steps to run now
+    void reset() { accumulator = 0; }   // Forget time that should not be simulated
+
+    float getStep() const { return step; }
+    float getAlpha() const { return accumulator / step; }  // 0 to 1 between the last step and the next
+    float getTimeToNextStep() const { return step - accumulator; }
+
+    // FIGHTGPT_TICK_RATE=<steps per second> overrides DEFAULT_RATE
+    static int configuredRate();
+
+private:
+    float step;
+    float accumulator;
+};
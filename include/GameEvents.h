@@ -0,0 +1,168 @@
+#pragma once
+
+#include "EventBus.h"
+#include "GameLogic.h"
+
+// Gameplay events. They hold numbers and pointers to live game objects only;
+// turning them into text is left to whichever subscriber needs it.
+
+enum class Combatant {
+    PLAYER,
+    ENEMY
+};
+
+enum class AttackKind {
+    NORMAL,
+    CRITICAL,
+    FIREBALL
+};
+
+enum class DiceOutcome {
+    HIT,
+    MARKED_HIT,
+    CRITICAL_HIT,
+    RAGE_CRITICAL_HIT,
+    CRITICAL_MISS,
+    MISS
+};
+
+enum class BattleOutcome {
+    WON,
+    LOST,
+    ESCAPED
+};
+
+enum class ItemUseResult {
+    HEALED,
+    ALREADY_FULL_HEALTH,
+    STRENGTHENED,
+    EQUIPPED,
+    REVEALED
+};
+
+enum class Ability {
+    RAGE,
+    FIREBALL,
+    HUNTERS_MARK
+};
+
+enum class SaveOperation {
+    SAVE,
+    LOAD
+};
+
+enum class SaveResult {
+    DONE,
+    REFUSED,  // Only saved outside battles, dice rolls and item choices
+    FAILED
+};
+
+struct CharacterCreated {
+    const Character* character;
+};
+
+struct PlayerMoved {
+    int x;
+    int y;
+};
+
+struct BattleStart {
+    const Character* player;
+    const Character* enemy;
+};
+
+// The player is asked to pick a combat action
+struct CombatPrompt {
+    const char* abilityDescription;  // nullptr when the special ability is not offered
+};
+
+struct EnemyTurnStarted {
+    const Character* enemy;
+};
+
+struct DiceRolled {
+    int roll;  // 0 when a guaranteed hit skipped the dice
+    DiceOutcome outcome;
+};
+
+struct EscapeAttempted {
+    int roll;  // 0 for the instant escape attempt
+    bool success;
+};
+
+struct DamageDealt {
+    Combatant attackerSide;
+    const Character* attacker;
+    const Character* target;
+    int amount;
+    AttackKind kind;
+    int marksRemaining;
+    const Item* weapon;  // nullptr when unarmed or not a weapon attack
+    float maxHealthShare;  // FIREBALL: the damage rolled as a share of the target's max HP, 0 otherwise
+};
+
+struct Dodged {
+    Combatant defenderSide;
+    const Character* attacker;
+    const Character* defender;
+};
+
+struct StatusDamage {
+    const Character* target;
+    StatusEffectType effect;
+    int amount;
+};
+
+struct BattleEnd {
+    const Character* enemy;
+    BattleOutcome outcome;
+};
+
+struct LevelUp {
+    const Character* character;
+    int level;
+};
+
+struct ItemFound {
+    const Item* item;
+};
+
+struct ItemPicked {
+    const Item* item;
+    bool added;  // false when the inventory was full
+};
+
+struct ItemLeft {
+    const Item* item;
+};
+
+struct ItemUsed {
+    const Character* user;
+    const Item* item;
+    ItemUseResult result;
+    int amount;  // HP healed or attack gained
+};
+
+struct InventoryShown {
+    const Character* owner;
+};
+
+struct AbilityUsed {
+    Ability ability;
+};
+
+struct SaveFinished {
+    SaveOperation operation;
+    SaveResult result;
+    float milliseconds;
+};
+
+struct TurnsRewound {
+    int turns;  // 0 when there was nothing to undo
+    float milliseconds;
+};
+
+using GameEventBus = EventBus<
+    CharacterCreated, PlayerMoved, BattleStart, CombatPrompt, EnemyTurnStarted,
+    DiceRolled, EscapeAttempted, DamageDealt, Dodged, StatusDamage, BattleEnd,
+    LevelUp, ItemFound, ItemPicked, ItemLeft, ItemUsed, InventoryShown, AbilityUsed, SaveFinished, TurnsRewound>;
@@ -4,6 +4,10 @@
 #include <vector>
 #include <random>
 #include <memory>
+#include "ObservableStats.h"
+#include "Pcg32.h"
+#include "StateHash.h"
+#include "StatusEffects.h"
 
 enum class ItemType {
     POTION,
@@ -29,99 +33,161 @@ public:
     Item(const std::string& name, const std::string& description, ItemType type, int effect_value = 0, ObjectEffect object_effect = ObjectEffect::REVEAL_BOSS)
         : name(name), description(description), type(type), effect_value(effect_value), object_effect(object_effect) {}
 
-    std::string GetName() const { return name; }
-    std::string GetDescription() const { return description; }
+    const std::string& GetName() const { return name; }
+    const std::string& GetDescription() const { return description; }
     ItemType GetType() const { return type; }
     int GetEffectValue() const { return effect_value; }
     ObjectEffect GetObjectEffect() const { return object_effect; }
 };
 
+// Every item the map can spawn. Saves store items as their index here, so new
+// items go at the end.
+const std::vector<Item>& GetItemCatalog();
+int FindCatalogItem(const Item& item);  // -1 for an item that is not in the catalog
+
 class Character {
+    friend class SaveGame;
+    friend class RewindBuffer;
+    friend class EffectList;
+
 protected:
+    // Features of the state hash; inventory slots follow each other from HASH_INVENTORY
+    enum HashFeature : uint32_t {
+        HASH_HEALTH,
+        HASH_MAX_HEALTH,
+        HASH_ATTACK,
+        HASH_DEFENSE,
+        HASH_SPEED,
+        HASH_AVOIDANCE,
+        HASH_LEVEL,
+        HASH_EXPERIENCE,
+        HASH_X,
+        HASH_Y,
+        HASH_FLAGS,     // Boss | ability used << 1
+        HASH_EQUIPPED,  // Catalog id + 1
+        HASH_EFFECTS,   // One per effect type: magnitude << 1 | 1 while active
+        HASH_INVENTORY = HASH_EFFECTS + static_cast<uint32_t>(StatusEffectType::COUNT)  // Catalog id + 1
+    };
+
+    // Declared before the observable stats, which hold references to them
+    StatNotifier statNotifier;
+    StateHash stateHash;
+
     std::string name;
-    int health;
-    int maxHealth;
-    int attack;
-    int defense;
-    int speed;
-    int avoidance;
-    int level;
-    int experience;
+    Observable<int> health{statNotifier, StatField::HEALTH, stateHash, HASH_HEALTH};
+    Observable<int> maxHealth{statNotifier, StatField::HEALTH, stateHash, HASH_MAX_HEALTH};
+    Observable<int> attack{statNotifier, StatField::ATTACK, stateHash, HASH_ATTACK};
+    Observable<int> defense{statNotifier, StatField::DEFENSE, stateHash, HASH_DEFENSE};
+    Observable<int> speed{statNotifier, StatField::SPEED, stateHash, HASH_SPEED};
+    Observable<int> avoidance{statNotifier, StatField::AVOIDANCE, stateHash, HASH_AVOIDANCE};
+    Observable<int> level{statNotifier, StatField::LEVEL, stateHash, HASH_LEVEL, 1};
+    Observable<int> experience{statNotifier, StatField::EXPERIENCE, stateHash, HASH_EXPERIENCE};
     int x;
     int y;
     bool boss;
-    bool isWounded;
     std::vector<std::shared_ptr<Item>> inventory;
     std::shared_ptr<Item> equipped_weapon;
     static const int MAX_INVENTORY_SIZE = 4;
     
     // Special ability properties
     bool abilityUsed;
-    bool isRage;        // For Knight: when true, forces critical hit
-    int markerCount;    // For Archer: counts remaining guaranteed hits
-    bool burnActive;    // For Mage: tracks if enemy is burning
-    
-    // Buff properties
-    int strengthBuff;   // Tracks temporary strength bonus
-    float strengthBuffDuration;  // Duration of strength buff in seconds
+
+    // Wounds, burns, ability states and buffs
+    EffectList effects;
+
+    static int64_t HashFlags(bool isBoss, bool used) { return (isBoss ? 1 : 0) | (used ? 2 : 0); }
+    static int64_t HashItem(const std::shared_ptr<Item>& item) { return item ? FindCatalogItem(*item) + 1 : 0; }
+
+    // Called once before and once after the inventory changes from slot `from` on
+    void ToggleInventoryHash(size_t from) {
+        for (size_t i = from; i < inventory.size(); ++i) {
+            stateHash.Toggle(HASH_INVENTORY + i, HashItem(inventory[i]));
+        }
+    }
+
+    void SetFlags(bool newBoss, bool newAbilityUsed) {
+        stateHash.Change(HASH_FLAGS, HashFlags(boss, abilityUsed), HashFlags(newBoss, newAbilityUsed));
+        boss = newBoss;
+        abilityUsed = newAbilityUsed;
+    }
+
+    void SetEquippedWeapon(std::shared_ptr<Item> weapon) {
+        stateHash.Change(HASH_EQUIPPED, HashItem(equipped_weapon), HashItem(weapon));
+        equipped_weapon = std::move(weapon);
+    }
 
 public:
-    Character() {}
+    Character() : x(0), y(0), boss(false), abilityUsed(false), effects(*this) {}
 
     Character(const std::string& name, int health, int attack, int defense, int speed, int avoidance)
         : name(name), 
-          health(health), 
-          maxHealth(health), 
-          attack(attack), 
-          defense(defense),
-          speed(speed), 
-          avoidance(avoidance), 
-          level(1),
-          experience(0),
+          health(statNotifier, StatField::HEALTH, stateHash, HASH_HEALTH, health), 
+          maxHealth(statNotifier, StatField::HEALTH, stateHash, HASH_MAX_HEALTH, health), 
+          attack(statNotifier, StatField::ATTACK, stateHash, HASH_ATTACK, attack), 
+          defense(statNotifier, StatField::DEFENSE, stateHash, HASH_DEFENSE, defense),
+          speed(statNotifier, StatField::SPEED, stateHash, HASH_SPEED, speed), 
+          avoidance(statNotifier, StatField::AVOIDANCE, stateHash, HASH_AVOIDANCE, avoidance), 
           x(0), 
           y(0),
           boss(false),
-          isWounded(false),
           abilityUsed(false),
-          isRage(false),
-          markerCount(0),
-          burnActive(false),
-          strengthBuff(0),
-          strengthBuffDuration(0.0f) {}
+          effects(*this) {}
 
-    virtual ~Character() = default;
+    // Listeners are dropped before the effect list clears itself, so nobody
+    // is told about a character that is going away
+    virtual ~Character() { statNotifier.Clear(); }
 
-    // Returns actual damage dealt, or 0 if avoided
-    virtual int TakeDamage(int damage);
+    // Returns actual damage dealt, or 0 if avoided. Avoidance and the damage
+    // spread are rolled on `rng`, so a seeded run plays out the same every time.
+    virtual int TakeDamage(int damage, Pcg32& rng);
     void LevelUp(int exp = 0);
     void ResetHealth() { health = maxHealth; }
-    bool IsDefeated() { return health <= 0; }
+    bool IsDefeated() const { return health <= 0; }
     void PrintStats() const;
 
-    int GetX() { return x; }
-    int GetY() { return y; }
-    void SetX(int new_x) { x = new_x; }
-    void SetY(int new_y) { y = new_y; }
-    int GetSpeed() { return speed; }
-    int GetAttack() { return attack; }
-    int GetLevel() { return level; }
+    int GetX() const { return x; }
+    int GetY() const { return y; }
+    void SetX(int new_x) {
+        stateHash.Change(HASH_X, x, new_x);
+        x = new_x;
+    }
+    void SetY(int new_y) {
+        stateHash.Change(HASH_Y, y, new_y);
+        y = new_y;
+    }
+    int GetSpeed() const { return speed; }
+    int GetAttack() const { return attack; }
+    int GetLevel() const { return level; }
     void SetLevel(int i) { level = i; }
-    std::string GetName() { return name; }
-    void SetBoss() { boss = true; }
-    bool GetBoss() { return boss; }
-    int GetHealth() { return health; }
-    int GetMaxHealth() { return maxHealth; }
-    int GetDefense() { return defense; }
+    const std::string& GetName() const { return name; }
+    void SetBoss() { SetFlags(true, abilityUsed); }
+    bool GetBoss() const { return boss; }
+    int GetHealth() const { return health; }
+    int GetMaxHealth() const { return maxHealth; }
+    int GetDefense() const { return defense; }
     int GetExperience() const { return experience; }
     int GetAvoidance() const { return avoidance; }
-    bool IsWounded() const { return isWounded; }
-    void SetWounded(bool wounded) { isWounded = wounded; }
-    void ApplyBleedDamage() {
-        if (isWounded) {
-            health = std::max(1, health - 5);
+    bool IsWounded() const { return effects.Has(StatusEffectType::WOUNDED); }
+    void SetWounded(bool wounded) {
+        if (wounded) {
+            effects.Apply(StatusEffectType::WOUNDED, 5, EffectDuration::Permanent());  // 5 HP bleed per turn
+        } else {
+            effects.Remove(StatusEffectType::WOUNDED);
         }
     }
 
+    // Damage over time from effect ticks never kills outright
+    void TakeEffectDamage(int amount) { health = std::max(1, health - amount); }
+
+    // Change notifications for the observable stats, effects and inventory
+    StatNotifier& GetStatNotifier() { return statNotifier; }
+
+    // Stats, position, flags, inventory and active effects; see Map::GetStateHash()
+    uint64_t GetStateHash() const { return stateHash.Get(); }
+
+    EffectList& GetEffects() { return effects; }
+    const EffectList& GetEffects() const { return effects; }
+
     void AddExperience(int exp) {
         experience += exp;
         while (experience >= level * 10) {
@@ -133,6 +199,8 @@ public:
     bool AddItem(std::shared_ptr<Item> item) {
         if (inventory.size() < MAX_INVENTORY_SIZE) {
             inventory.push_back(item);
+            stateHash.Toggle(HASH_INVENTORY + inventory.size() - 1, HashItem(item));
+            statNotifier.Notify(StatBit(StatField::INVENTORY));
             return true;
         }
         return false;
@@ -140,7 +208,10 @@ public:
 
     bool RemoveItem(int index) {
         if (index >= 0 && static_cast<size_t>(index) < inventory.size()) {
+            ToggleInventoryHash(index);  // The later items move down a slot
             inventory.erase(inventory.begin() + index);
+            ToggleInventoryHash(index);
+            statNotifier.Notify(StatBit(StatField::INVENTORY));
             return true;
         }
         return false;
@@ -153,7 +224,8 @@ public:
     void EquipWeapon(int index) {
         if (index >= 0 && static_cast<size_t>(index) < inventory.size() && 
             inventory[index]->GetType() == ItemType::WEAPON) {
-            equipped_weapon = inventory[index];
+            SetEquippedWeapon(inventory[index]);
+            statNotifier.Notify(StatBit(StatField::INVENTORY));
         }
     }
 
@@ -162,7 +234,7 @@ public:
     }
 
     int GetTotalAttack() const {
-        int total = attack + strengthBuff;  // Add strength buff to base attack
+        int total = attack + effects.GetMagnitude(StatusEffectType::STRENGTH_BUFF);  // Add strength buff to base attack
         if (equipped_weapon) {
             total += equipped_weapon->GetEffectValue();
         }
@@ -171,64 +243,45 @@ public:
 
     // Special ability methods
     bool HasUsedAbility() const { return abilityUsed; }
-    void SetAbilityUsed(bool used) { abilityUsed = used; }
+    void SetAbilityUsed(bool used) { SetFlags(boss, used); }
     
     void ResetAbility() { 
-        abilityUsed = false;
-        isRage = false;
-        markerCount = 0;
-        burnActive = false;
+        SetAbilityUsed(false);
+        effects.Remove(StatusEffectType::RAGE);
+        effects.Remove(StatusEffectType::HUNTERS_MARK);
+        effects.Remove(StatusEffectType::BURN);
     }
     
     // Rage ability
-    bool IsRageActive() const { return isRage; }
+    bool IsRageActive() const { return effects.Has(StatusEffectType::RAGE); }
     void ActivateRage() { 
-        isRage = true;
-        abilityUsed = true;
+        effects.Apply(StatusEffectType::RAGE, 1, EffectDuration::Permanent());
+        SetAbilityUsed(true);
     }
-    void DeactivateRage() { isRage = false; }
+    void DeactivateRage() { effects.Remove(StatusEffectType::RAGE); }
     
     // Hunter's Mark ability
-    bool HasMarker() const { return markerCount > 0; }
-    int GetMarkerCount() const { return markerCount; }
+    bool HasMarker() const { return effects.Has(StatusEffectType::HUNTERS_MARK); }
+    int GetMarkerCount() const { return effects.GetMagnitude(StatusEffectType::HUNTERS_MARK); }
     void ActivateMarker() {
-        markerCount = 3;
-        abilityUsed = true;
-    }
-    void DecrementMarker() {
-        if (markerCount > 0) {
-            markerCount--;
-        }
+        effects.Apply(StatusEffectType::HUNTERS_MARK, 3, EffectDuration::Permanent());
+        SetAbilityUsed(true);
     }
+    void DecrementMarker() { effects.ConsumeMagnitude(StatusEffectType::HUNTERS_MARK); }
     
     // Burn ability
-    bool IsBurning() const { return burnActive; }
+    bool IsBurning() const { return effects.Has(StatusEffectType::BURN); }
     void ApplyBurn() {
-        burnActive = true;
-    }
-    void ApplyBurnDamage() {
-        if (burnActive) {
-            health = std::max(1, health - 5); // 5 HP burn damage per turn
-        }
+        effects.Apply(StatusEffectType::BURN, 5, EffectDuration::Permanent());  // 5 HP burn damage per turn
     }
 
     // Buff methods
     void ApplyStrengthBuff(int bonus) {
-        strengthBuff = bonus;
-        strengthBuffDuration = 30.0f;  // Buff lasts for 30 seconds
-    }
-
-    void UpdateBuffs(float deltaTime) {
-        if (strengthBuffDuration > 0) {
-            strengthBuffDuration -= deltaTime;
-            if (strengthBuffDuration <= 0) {
-                strengthBuff = 0;  // Remove buff when duration expires
-            }
-        }
+        effects.Apply(StatusEffectType::STRENGTH_BUFF, bonus, EffectDuration::Seconds(30.0f));  // Buff lasts for 30 seconds
     }
 
-    bool HasStrengthBuff() const { return strengthBuff > 0; }
-    float GetStrengthBuffDuration() const { return strengthBuffDuration; }
+    bool HasStrengthBuff() const { return effects.Has(StatusEffectType::STRENGTH_BUFF); }
+    float GetStrengthBuffDuration() const { return effects.GetRemainingSeconds(StatusEffectType::STRENGTH_BUFF); }
 };
 
 class Battle {
@@ -238,16 +291,48 @@ public:
 };
 
 class Map {
+    friend class SaveGame;
+    friend class RewindBuffer;
+
 private:
     int width;
     int height;
     std::vector<std::vector<Character*>> grid;
     std::vector<std::vector<std::shared_ptr<Item>>> item_grid;
     std::vector<std::vector<bool>> walls; // Grid to track walls
-    std::mt19937 rng;
+    unsigned wallRevision; // Bumped whenever the wall layout changes
+    std::vector<std::pair<int, int>> changedCells; // Cells whose occupant or item changed since the last clear
+    std::vector<std::unique_ptr<Character>> enemies; // Monsters and boss owned by the map
+    Pcg32 rng;
+
+    // Walls, occupied cells and items; who stands where is in the characters' own hashes
+    enum HashFeature : uint32_t {
+        HASH_WALL,
+        HASH_OCCUPIED,
+        HASH_ITEM,  // Catalog id + 1
+        HASH_FEATURES_PER_CELL
+    };
+    StateHash stateHash;
+
+    Map(int width, int height, const Pcg32& rng); // Empty map, filled in by a loader
+
+    // Every change to the grids goes through these, which keep the hash in step
+    uint64_t CellFeature(int x, int y, HashFeature feature) const {
+        return (static_cast<uint64_t>(y) * width + x) * HASH_FEATURES_PER_CELL + feature;
+    }
+    void SetOccupant(int x, int y, Character* character) {
+        stateHash.Change(CellFeature(x, y, HASH_OCCUPIED), grid[x][y] != nullptr, character != nullptr);
+        grid[x][y] = character;
+    }
+    void SetItem(int x, int y, std::shared_ptr<Item> item);
+    void SetWall(int x, int y, bool wall) {
+        stateHash.Change(CellFeature(x, y, HASH_WALL), walls[x][y], wall);
+        walls[x][y] = wall;
+    }
 
 public:
-    Map(int width, int height);
+    Map(int width, int height); // Seeded from the random device
+    Map(int width, int height, uint64_t seed); // The same seed always generates the same map
     void PlaceCharacter(Character& character);
     void MoveCharacter(Character& character, int dx, int dy);
     void PopulateMonsters(int n);
@@ -263,6 +348,21 @@ public:
     void RemoveItemAtPosition(int x, int y);
     void PlaceItem(std::shared_ptr<Item> item);
     std::vector<std::shared_ptr<Item>> CreateRandomItems(int count);
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
     Character* GetCharacterAt(int x, int y) const { return grid[x][y]; }
     bool HasWall(int x, int y) const { return walls[x][y]; } // Check if position has a wall
+    unsigned GetWallRevision() const { return wallRevision; }
+
+    // 64-bit hash of the whole game state: this map and the stats, effects and
+    // positions of the player and every enemy. Each part is kept up to date as
+    // it changes, so this costs one combine per character. Equal states hash
+    // equally however they were reached, which makes it a transposition key
+    // for searches over game states as well as a check that two runs agree.
+    uint64_t GetStateHash(const Character& player) const;
+
+    // Cells that gained or lost a character or item, in order and possibly
+    // repeated; the UI consumes them and clears the list once per frame
+    const std::vector<std::pair<int, int>>& GetChangedCells() const { return changedCells; }
+    void ClearChangedCells() { changedCells.clear(); }
 }; 
\ No newline at end of file
@@ -2,81 +2,71 @@
 
 #include "GameState.h"
 #include "GameLogic.h"
+#include "CombatLog.h"
+#include "GameSimulation.h"
+#include "Minimap.h"
+#include "RenderSnapshot.h"
+#include "SpriteBatch.h"
+#include "TextCache.h"
+#include "TextureAtlas.h"
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <string>
 #include <memory>
 #include <vector>
-#include <deque>
-#include <functional>
 #include <sstream>
 
-
-// Forward declarations of the original game classes
-class Character;
-class Map;
-
+// Draws the game and forwards input to the GameSimulation, which plays it on
+// its own thread. Each frame takes the newest snapshot and refreshes only the
+// text and geometry whose values changed since the one drawn before.
 class GamePlayState : public GameState {
 public:
-    GamePlayState(int selectedCharacter, const std::string& playerName, const std::string& bossName);
-    ~GamePlayState() override = default;
+    GamePlayState(int selectedCharacter, const std::string& playerName, const std::string& bossName,
+                  sf::Vector2i mapSize = configuredMapSize());
+    ~GamePlayState() override;
 
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool isAnimating() const override;
+    void onPause() override;
+    void onResume(std::unique_ptr<GameState> popped) override;
+
+    // FIGHTGPT_MAP_SIZE=<size> or <width>x<height> overrides the default dungeon size
+    static sf::Vector2i configuredMapSize();
 
 private:
-    enum class CombatState {
-        NOT_IN_COMBAT,
-        PLAYER_TURN,
-        ENEMY_TURN,
-        TRYING_ESCAPE
-    };
+    // Map geometry: the camera shows VIEW_CELLS x VIEW_CELLS cells around the
+    // player, whatever the size of the map
+    static const int CELL_SIZE = 40;
+    static const int VIEW_CELLS = 15;
+    static const int SIGHT_RADIUS = GameSimulation::SIGHT_RADIUS;
+    static const int DEFAULT_MAP_SIZE = 15;
+    static const int MIN_MAP_SIZE = 10;
+    static const int MAX_MAP_SIZE = 4096;
 
-    // Member variables (ordered to match initialization)
-    std::unique_ptr<Character> player;
-    std::unique_ptr<Map> gameMap;
-    Character* currentEnemy;
-    CombatState combatState;
+    // Member variables (ordered to match initialization). The simulation
+    // thread only ever touches the GameSimulation's own members.
+    GameSimulation simulation;
     int selectedCharacter;
     std::string playerName;
     std::string bossName;
-    bool gameOver;
-    int currentDiceValue;
-    float diceAnimationTime;
-    bool isRollingDice;
-    bool showingItemPrompt;
-    std::shared_ptr<Item> currentItem;
-    bool bossRevealed;
-    bool itemsRevealed;
-    bool monstersRevealed;
+    uint64_t inputsSent = 0;
+    std::unique_ptr<GameState> pauseScreen;  // Built with the game, pushed on Space and handed back on resume
 
     // Graphics-related members
-    sf::Font font;
+    std::shared_ptr<const sf::Font> font;
+    TextCache textCache;
     sf::Text characterNameText;
-    sf::Text statsText;
     sf::Text enemyText;
     sf::RectangleShape playerShape;
     sf::RectangleShape healthBar;
     sf::RectangleShape healthBarBackground;
     sf::RectangleShape characterInfoBox;
     sf::RectangleShape combatLogBox;
-    sf::Texture classIcon;
     sf::Sprite iconSprite;
     
-    // New declarations
-    sf::Texture playerTexture; // Texture for the player character
-    sf::Sprite playerSprite;   // Sprite for the player character
-    
-    // Add new texture and sprite members for monsters, boss, and items
-    sf::Texture monsterTexture;
-    sf::Texture bossTexture;
-    sf::Texture itemTexture;
-    sf::Sprite monsterSprite;
-    sf::Sprite bossSprite;
-    sf::Sprite itemSprite;
-    
     // Dice-related members
-    sf::Texture diceTexture;
     sf::Sprite diceSprite;
     sf::Text diceText;
     
@@ -85,54 +75,97 @@ private:
     std::vector<sf::Text> inventoryTexts;
     std::vector<sf::RectangleShape> inventorySlots;
     
+    // Stats panel: one text per line, each bound to the stat fields it shows.
+    // Snapshot values that differ from the ones on screen are collected in
+    // pendingStatChanges and only the lines that depend on them are
+    // reformatted on the next update.
+    enum StatLineIndex {
+        LEVEL_LINE,
+        HEALTH_LINE,
+        ATTACK_LINE,
+        DEFENSE_LINE,
+        SPEED_LINE,
+        AVOIDANCE_LINE,
+        EXPERIENCE_LINE,
+        STAT_LINE_COUNT
+    };
+    struct StatLine {
+        sf::Text text;
+        StatMask fields = 0;
+    };
+    std::array<StatLine, STAT_LINE_COUNT> statLines;
+    StatMask pendingStatChanges = ALL_STATS;
+
+    // Snapshot values currently on screen
+    RenderSnapshot::PlayerStats shownStats;
+    std::array<std::string, RenderSnapshot::INVENTORY_SLOTS> shownInventory;
+    int shownEquippedSlot = -1;
+    int shownDiceValue = 0;
+    bool shownGameOver = false;
+    uint64_t shownLogSequence = 0;
+    uint64_t shownLogCleared = 0;
+
     // Combat log elements
     sf::RectangleShape combatLogBackground;
-    std::deque<std::string> combatLog;
-    std::vector<sf::Text> combatLogTexts;
-    std::vector<sf::RectangleShape> combatLogBackgrounds;
-    static const size_t MAX_LOG_LINES = 25;
+    CombatLog combatLog;
 
-    // Map-related textures
-    sf::Texture backgroundTexture;
-    sf::Sprite backgroundSprite;
-    sf::Texture wallTexture;
-    sf::Sprite wallSprite;
+    // Enemy panel and end screen; the text itself comes from textCache
+    sf::RectangleShape enemyInfoBox;
+    std::string enemyInfoString;
+    RenderSnapshot::EnemyStats enemyInfoSource;
+    sf::RectangleShape gameOverOverlay;
+
+    // Map rendering: sprites come from the baked atlas and the map is drawn in
+    // three batches (floor and walls, entities, enemy names)
+    SpriteAtlas::Sprite playerMapSprite = SpriteAtlas::Sprite::MAP_KNIGHT;
+    SpriteBatch floorBatch;
+    SpriteBatch entityBatch;
+    SpriteBatch overlayBatch;
+    RenderStats mapRenderStats;
+
+    // Camera over the map in world pixels (CELL_SIZE per cell) and the cells
+    // it covers; drawing only iterates those cells
+    struct CellRange {
+        int left = 0;
+        int top = 0;
+        int right = 0;   // Exclusive
+        int bottom = 0;  // Exclusive
+    };
+    sf::View mapCamera;
+    CellRange cameraCells;
+
+    // Overview of the whole map, updated per changed cell
+    Minimap minimap;
+
+    // Background, grid lines and visible walls under the camera, composed
+    // off-screen and only redrawn when the player's view or the walls change
+    sf::RenderTexture mapLayer;
+    sf::Sprite mapLayerSprite;
+    bool mapLayerValid = false;
+    int mapLayerPlayerX = 0;
+    int mapLayerPlayerY = 0;
+    unsigned mapLayerWallRevision = 0;
 
     // Methods
-    void initializeStats();
-    void updateStatsText();
+    void applySnapshot(const RenderSnapshot& snapshot);
+    void diffStats(const RenderSnapshot& snapshot);
+    void syncCombatLog(const RenderSnapshot& snapshot);
+    void refreshBoundText();
+    std::string formatStatLine(StatLineIndex line) const;
     void updateEnemyDisplays();
+    void updateEnemyInfo(const RenderSnapshot::EnemyStats& enemy);
     void drawGrid(sf::RenderWindow& window);
-    void drawBackground(sf::RenderWindow& window);
-    void drawWalls(sf::RenderWindow& window);
-    void handleCombat(Character* enemy);
-    void handleEnemyTurn(Character* enemy);
-    void handleVictory(Character& enemy);
-    void handlePlayerAttack();
-    void handlePlayerEscape();
-    void addCombatLogMessage(const std::string& message);
-    void loadClassIcon(int selectedCharacter);
-    
-    // Special ability methods
-    void handlePlayerAbility();
-    void performRageAbility();
-    void performFireballAbility();
-    void performHeadshotAbility();
-    std::string getAbilityDescription() const;
-    
+    sf::Vector2f getMapScreenPosition(const sf::RenderTarget& target) const;
+    void updateCamera(const sf::RenderTarget& target);
+    void redrawMapLayer();
+    void addBackgroundQuads();
+    void addWallQuads();
+    void loadClassSprites(int selectedCharacter);
+
     // Inventory-related methods
     void initializeInventoryUI();
     void updateInventoryDisplay();
-    void handleItemPickup();
-    void handleItemUse(int index);
-    void checkForItems();
-    void displayInventoryInLog();
-    
+
     // Dice related methods
-    void startDiceRoll();
-    void updateDiceRoll(float deltaTime);
     void updateDiceText();
-    void handleDiceResult(int roll, bool isAttack);
-    void performPlayerAttack(bool isCritical);
-    int rollD20() { return (rand() % 20) + 1; }
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CombatLogFeed.h"
+#include "CombatLogSink.h"
+#include "GameEvents.h"
+#include "GameLogic.h"
+#include "Minimap.h"
+#include "RenderSnapshot.h"
+#include "ReplayLog.h"
+#include "RewindBuffer.h"
+#include "SaveGame.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+// The rules of one run through the dungeon, played on a thread of its own so
+// that a slow turn (monster moves on a big map, the pauses between combat
+// turns) never holds up a frame. The render thread sends key presses through
+// a lock-free queue and draws the latest RenderSnapshot taken from a triple
+// buffer; the only other shared state is the minimap feed.
+class GameSimulation {
+public:
+    static const int SIGHT_RADIUS = 3;     // Cells around the player that are always visible
+    static const int SNAPSHOT_RADIUS = 16; // Cells around the player copied into snapshots; covers the camera
+
+    GameSimulation(int selectedCharacter, const std::string& playerName, sf::Vector2i mapSize);
+    ~GameSimulation();
+    GameSimulation(const GameSimulation&) = delete;
+    GameSimulation& operator=(const GameSimulation&) = delete;
+
+    void start();
+    void stop();  // Joins the thread; safe to call more than once
+    void setPaused(bool pause) { paused.store(pause, std::memory_order_relaxed); }  // Game time stands still
+
+    // Render thread. pushInput() returns false when the queue is full and the
+    // event was dropped; updateSnapshot() returns true when a newer snapshot
+    // replaced the one returned by getSnapshot().
+    bool pushInput(const sf::Event& event) { return inputs.push(event); }
+    bool updateSnapshot() { return snapshots.update(); }
+    const RenderSnapshot& getSnapshot() const { return snapshots.front(); }
+    MinimapFeed& getMinimapFeed() { return minimapFeed; }
+
+private:
+    static const size_t INPUT_CAPACITY = 64;
+
+    enum class CombatState {
+        NOT_IN_COMBAT,
+        PLAYER_TURN,
+        ENEMY_TURN,
+        TRYING_ESCAPE
+    };
+
+    void run();
+    bool tick(float deltaTime);  // One fixed step; returns true when the state may have changed
+    void publish();
+    void fillMapWindow(RenderSnapshot& snapshot) const;
+    bool isAnimating() const;
+    void onStatsChanged(StatMask changed);
+
+    void initializeStats();
+    SaveGame::Run getRun() const;
+    void setRun(const SaveGame::Run& run);
+    void resetEncounter();  // Drops any battle, dice roll or item prompt in progress
+    std::string getSavePath() const;  // SaveGame::DEFAULT_PATH unless a replay is recorded or played
+    void saveGame();  // F5, to getSavePath()
+    void loadGame();  // F8, replacing the whole run
+    void rewindTurns(int turns);  // Backspace undoes one turn
+    void endTurn();  // Records the turn for undo and in the replay log
+    bool playReplayKeys();  // The keys a replay has due by now; true if any were played
+    void handleEvent(const sf::Event& event);
+    void handleCombat(Character* enemy);
+    void handleEnemyTurn(Character* enemy);
+    void handleVictory(Character& enemy);
+    void handlePlayerAttack();
+    void handlePlayerEscape();
+    void showCombatOptions(bool offerAbility);
+
+    // Special ability methods
+    void handlePlayerAbility();
+    void performRageAbility();
+    void performFireballAbility();
+    void performHeadshotAbility();
+    const char* getAbilityDescription() const;
+
+    // Inventory-related methods
+    void handleItemPickup();
+    void handleItemUse(int index);
+    void checkForItems();
+
+    // Dice related methods
+    void startDiceRoll();
+    void updateDiceRoll(float deltaTime);
+    void handleDiceResult(int roll, bool isAttack);
+    void performPlayerAttack(bool isCritical);
+    int rollD20() { return std::uniform_int_distribution<int>(1, 20)(diceRng); }
+
+    // Game state, only touched by the simulation thread once started
+    std::unique_ptr<Character> player;
+    std::unique_ptr<Map> gameMap;
+    Character* currentEnemy;
+    CombatState combatState;
+    int selectedCharacter;
+    std::string playerName;
+    bool gameOver;
+    bool returnToMenu;
+    int currentDiceValue;
+    Pcg32 diceRng;  // Dice, escape and damage rolls; saved with the run
+    float diceAnimationTime;
+    bool isRollingDice;
+    bool showingItemPrompt;
+    std::shared_ptr<Item> currentItem;
+    bool bossRevealed;
+    bool itemsRevealed;
+    bool monstersRevealed;
+    bool statsChanged;
+    uint64_t inputsConsumed;
+    uint64_t publishedLogSequence;
+    bool turnPending;  // An action was taken and its turn is not recorded yet
+    uint32_t turnSteps;  // Fixed steps since the last turn ended
+
+    // Every recorded turn, for undo
+    RewindBuffer rewind;
+
+    // FIGHTGPT_REPLAY recording or replay of this run
+    ReplayLog replay;
+
+    // Gameplay events; the combat log is one subscriber among others
+    CombatLogFeed combatLog;
+    GameEventBus events;
+    CombatLogSink combatLogSink{combatLog};
+
+    // Shared with the render thread
+    SpscQueue<sf::Event, INPUT_CAPACITY> inputs;
+    TripleBuffer<RenderSnapshot> snapshots;
+    MinimapFeed minimapFeed;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> paused{false};
+    std::thread thread;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <cstddef>
 #include <memory>
 
 class GameState {
@@ -11,14 +12,59 @@ public:
     virtual void update(float deltaTime) = 0;
     virtual void draw(sf::RenderWindow& window) = 0;
     
+    // Called by the StateStack: onEnter() once the state is first on top,
+    // onExit() before it is removed. onPause() when another state is pushed
+    // over it and onResume() when that one is popped again; the popped state
+    // is handed back so it can be kept for the next push instead of rebuilt.
     virtual void onEnter() {}
     virtual void onExit() {}
+    virtual void onPause() {}
+    virtual void onResume(std::unique_ptr<GameState> /*popped*/) {}
+
+    // Overlays are drawn over the state beneath them, which shows its last frame
+    virtual bool isOverlay() const { return false; }
+
+    // While a state is not animating the main loop sleeps in waitEvent and
+    // only redraws after input or an explicit requestRedraw()
+    virtual bool isAnimating() const { return false; }
+    bool needsRedraw() const { return redrawRequested || isAnimating(); }
+    void requestRedraw() { redrawRequested = true; }
+    void clearRedraw() { redrawRequested = false; }
+
+    // update() always advances by one fixed step. Frames fall between steps,
+    // so states with continuous motion draw their previous and current values
+    // blended by how far the frame is past the last step, from 0 to 1.
+    void setInterpolation(float alpha) { interpolation = alpha; }
+
+    // A change to the stack asked for during handleEvent() or update(); the
+    // StateStack applies it after the step
+    struct Transition {
+        enum class Kind { NONE, PUSH, POP, REPLACE };
+        Kind kind = Kind::NONE;
+        std::unique_ptr<GameState> state;  // For PUSH and REPLACE
+        size_t popCount = 0;
+    };
+    bool hasTransition() const { return transition.kind != Transition::Kind::NONE; }
+    Transition takeTransition() {
+        Transition taken = std::move(transition);
+        transition = Transition();
+        return taken;
+    }
 
 protected:
-    std::unique_ptr<GameState> nextState;
+    void pushState(std::unique_ptr<GameState> state) { request(Transition::Kind::PUSH, std::move(state), 0); }
+    void replaceState(std::unique_ptr<GameState> state) { request(Transition::Kind::REPLACE, std::move(state), 0); }
+    void popState(size_t count = 1) { request(Transition::Kind::POP, nullptr, count); }
 
-public:
-    std::unique_ptr<GameState> getNextState() {
-        return std::move(nextState);
+    bool redrawRequested = true;
+    float interpolation = 1.0f;
+
+private:
+    void request(Transition::Kind kind, std::unique_ptr<GameState> state, size_t popCount) {
+        transition.kind = kind;
+        transition.state = std::move(state);
+        transition.popCount = popCount;
     }
-}; 
\ No newline at end of file
+
+    Transition transition;
+};
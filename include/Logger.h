@@ -1,23 +1,111 @@
 #pragma once
-#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string>
-#include <ctime>
+#include <string_view>
+#include <type_traits>
+
+// Levels below this threshold compile to nothing (0 = DEBUG, 1 = INFO, 2 = ERROR)
+#ifndef FIGHTGPT_LOG_LEVEL
+#define FIGHTGPT_LOG_LEVEL 1
+#endif
+
+enum class LogLevel : uint8_t {
+    DEBUG = 0,
+    INFO = 1,
+    ERROR = 2
+};
+
+// Fixed-size record pushed by producers; the message is formatted in place so
+// logging never allocates.
+struct LogRecord {
+    static const size_t MAX_TEXT = 238;
+
+    uint64_t position;  // Ring position claimed by the producer
+    int64_t timestamp;  // Nanoseconds since the Unix epoch
+    uint32_t thread;    // Small per-thread id, see Logger::threadId
+    LogLevel level;
+    uint8_t length;
+    char text[MAX_TEXT];
+};
 
 class Logger {
 public:
-    static void info(const std::string& message) {
-        log("INFO", message);
+    template <typename... Args>
+    static void debug(const Args&... args) {
+        if constexpr (static_cast<int>(LogLevel::DEBUG) >= FIGHTGPT_LOG_LEVEL) {
+            log(LogLevel::DEBUG, args...);
+        }
     }
-    
-    static void error(const std::string& message) {
-        log("ERROR", message);
+
+    template <typename... Args>
+    static void info(const Args&... args) {
+        if constexpr (static_cast<int>(LogLevel::INFO) >= FIGHTGPT_LOG_LEVEL) {
+            log(LogLevel::INFO, args...);
+        }
     }
-    
+
+    template <typename... Args>
+    static void error(const Args&... args) {
+        if constexpr (static_cast<int>(LogLevel::ERROR) >= FIGHTGPT_LOG_LEVEL) {
+            log(LogLevel::ERROR, args...);
+        }
+    }
+
+    // Blocks until every record pushed so far has been written out
+    static void flush();
+
+    static uint32_t threadId();
+
 private:
-    static void log(const std::string& level, const std::string& message) {
-        time_t now = time(0);
-        std::string timestamp = ctime(&now);
-        timestamp.pop_back(); // Remove newline
-        std::cout << "[" << timestamp << "] [" << level << "] " << message << std::endl;
+    template <typename... Args>
+    static void log(LogLevel level, const Args&... args) {
+        LogRecord* record = acquire();
+        if (!record) return;  // Ring is full; the drop is counted and reported by the writer
+
+        record->level = level;
+        size_t length = 0;
+        (append(record->text, length, args), ...);
+        record->length = static_cast<uint8_t>(length);
+        publish(record);
     }
-}; 
\ No newline at end of file
+
+    static void append(char* text, size_t& length, std::string_view value) {
+        size_t n = std::min(value.size(), LogRecord::MAX_TEXT - length);
+        std::memcpy(text + length, value.data(), n);
+        length += n;
+    }
+
+    static void append(char* text, size_t& length, const std::string& value) {
+        append(text, length, std::string_view(value));
+    }
+
+    static void append(char* text, size_t& length, const char* value) {
+        append(text, length, std::string_view(value));
+    }
+
+    static void append(char* text, size_t& length, char value) {
+        append(text, length, std::string_view(&value, 1));
+    }
+
+    template <typename T>
+    static std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, char>>
+    append(char* text, size_t& length, T value) {
+        char* end = text + LogRecord::MAX_TEXT;
+        if constexpr (std::is_same_v<T, bool>) {
+            append(text, length, value ? "true" : "false");
+        } else if constexpr (std::is_integral_v<T>) {
+            auto result = std::to_chars(text + length, end, value);
+            if (result.ec == std::errc()) length = result.ptr - text;
+        } else if (length < LogRecord::MAX_TEXT) {
+            int n = std::snprintf(text + length, end - (text + length), "%.2f", static_cast<double>(value));
+            if (n > 0) length = std::min(LogRecord::MAX_TEXT - 1, length + static_cast<size_t>(n));
+        }
+    }
+
+    static LogRecord* acquire();
+    static void publish(LogRecord* record);
+};
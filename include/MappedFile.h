@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A whole file mapped read-only into memory, unmapped on destruction
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);  // False if missing, empty or not mappable
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+};
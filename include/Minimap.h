@@ -0,0 +1,108 @@
+#pragma once
+
+#include "SpscQueue.h"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Map;
+
+// What the player currently knows about the map
+struct MinimapVisibility {
+    int playerX = 0;
+    int playerY = 0;
+    int sightRadius = 0;
+    bool bossRevealed = false;
+    bool itemsRevealed = false;
+    bool monstersRevealed = false;
+};
+
+// One recoloured minimap cell. The generation ties it to the full image it
+// applies on top of; texels from before a rebuild are dropped.
+struct MinimapTexel {
+    uint16_t x = 0;
+    uint16_t y = 0;
+    uint32_t generation = 0;
+    sf::Color color;
+};
+
+// Simulation side of the minimap, one texel per cell. Only the cells that
+// changed since the last update are recoloured and queued for the render
+// thread: the sight square around the player when it moves, and the cells the
+// map reports as changed. A new wall layout, an item revealing things across
+// the whole map or a full queue hands over a complete image instead.
+class MinimapFeed {
+public:
+    static const size_t QUEUE_CAPACITY = 16384;
+
+    struct FullImage {
+        sf::Image image;
+        uint32_t generation = 0;
+    };
+
+    MinimapFeed();
+    ~MinimapFeed();
+    MinimapFeed(const MinimapFeed&) = delete;
+    MinimapFeed& operator=(const MinimapFeed&) = delete;
+
+    // Simulation thread
+    void update(const Map& map, const MinimapVisibility& visibility);
+
+    // Render thread
+    std::unique_ptr<FullImage> takeImage();  // Null when no rebuild is waiting
+    bool popTexel(MinimapTexel& texel) { return texels.pop(texel); }
+
+private:
+    void rebuild(const Map& map);
+    void refreshArea(const Map& map, int left, int top, int right, int bottom);  // Right and bottom are exclusive
+    void exploreSight(int centreX, int centreY);
+    sf::Color cellColor(const Map& map, int x, int y) const;
+
+    int width;
+    int height;
+    bool built;
+    bool overflowed;  // A texel did not fit in the queue; the next update rebuilds
+    unsigned wallRevision;
+    uint32_t generation;
+    MinimapVisibility shown;
+    std::vector<bool> explored;
+
+    SpscQueue<MinimapTexel, QUEUE_CAPACITY> texels;
+    std::atomic<FullImage*> pendingImage{nullptr};  // Owned; exchanged between the threads
+};
+
+// Render side: the minimap texture, kept in step with a MinimapFeed. Texels
+// are uploaded as horizontal runs, so a refreshed square costs one texture
+// update per row.
+class Minimap : public sf::Drawable {
+public:
+    Minimap();
+
+    void setPanel(const sf::FloatRect& panel);
+    void sync(MinimapFeed& feed);
+    void setCameraCells(const sf::IntRect& cells);  // Outlines what the main view shows
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    bool applyImage(MinimapFeed& feed);
+    void placeSprite();
+    void flushRun();
+
+    sf::Texture texture;
+    sf::Sprite sprite;
+    sf::RectangleShape background;
+    sf::RectangleShape cameraOutline;
+    sf::FloatRect panel;
+    float scale;
+
+    int width;
+    int height;
+    uint32_t generation;
+
+    // Adjacent texels of one row waiting to be uploaded together
+    std::vector<sf::Uint8> run;
+    int runX;
+    int runY;
+};
@@ -2,6 +2,7 @@
 
 #include "GameState.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <string>
 
 class NameInputState : public GameState {
@@ -12,6 +13,7 @@ public:
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool isAnimating() const override { return !logoShown; }  // Loading bar until the atlas is in
 
 private:
     static const size_t MAX_NAME_LENGTH = 20;
@@ -21,14 +23,16 @@ private:
     const int windowHeight;
     
     // Member variables
-    sf::Font font;
-    sf::Texture logoTexture;
+    std::shared_ptr<const sf::Font> font;
     sf::Sprite logoSprite;
+    sf::RectangleShape loadingBar;
+    bool logoShown;
     sf::Text titleText;
     sf::Text inputText;
     sf::Text instructionText;
     sf::RectangleShape inputBox;
     std::string playerName;
 
+    void showLogo();
     void updateText();
 }; 
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "StateHash.h"
+
+// Character values a UI can bind to. Several stats that are always shown
+// together share a field (health covers max health, inventory covers the
+// equipped weapon).
+enum class StatField {
+    HEALTH,
+    ATTACK,
+    DEFENSE,
+    SPEED,
+    AVOIDANCE,
+    LEVEL,
+    EXPERIENCE,
+    EFFECTS,
+    INVENTORY,
+    COUNT
+};
+
+using StatMask = uint32_t;
+
+constexpr StatMask StatBit(StatField field) { return StatMask(1) << static_cast<unsigned>(field); }
+
+const StatMask ALL_STATS = StatBit(StatField::COUNT) - 1;
+
+// Per-character change notifications. Listeners receive a mask of the fields
+// that changed and are expected to record it and refresh later, so a burst of
+// changes in one turn costs one refresh.
+class StatNotifier {
+public:
+    static const size_t MAX_LISTENERS = 4;
+
+    StatNotifier() = default;
+    StatNotifier(const StatNotifier&) = delete;
+    StatNotifier& operator=(const StatNotifier&) = delete;
+
+    // Returns false when MAX_LISTENERS are already registered
+    template <typename Owner, void (Owner::*Handler)(StatMask)>
+    bool Subscribe(Owner* owner) {
+        if (count == MAX_LISTENERS) return false;
+        listeners[count++] = {owner, [](void* target, StatMask changed) {
+            (static_cast<Owner*>(target)->*Handler)(changed);
+        }};
+        return true;
+    }
+
+    void Unsubscribe(const void* owner) {
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (listeners[i].owner != owner) listeners[kept++] = listeners[i];
+        }
+        count = kept;
+    }
+
+    void Clear() { count = 0; }
+
+    void Notify(StatMask changed) const {
+        for (size_t i = 0; i < count; ++i) {
+            listeners[i].handler(listeners[i].owner, changed);
+        }
+    }
+
+private:
+    struct Listener {
+        void* owner;
+        void (*handler)(void* owner, StatMask changed);
+    };
+
+    std::array<Listener, MAX_LISTENERS> listeners{};
+    size_t count = 0;
+};
+
+// A stat value that notifies its owner's StatNotifier when it actually changes.
+// Reads convert implicitly, so game logic keeps using it like a plain value.
+template <typename T>
+class Observable {
+public:
+    Observable(StatNotifier& notifier, StatField field, T value = T())
+        : value(value), notifier(notifier), field(field) {}
+
+    // Also keeps the key of `feature` in `hash` in step with the value
+    Observable(StatNotifier& notifier, StatField field, StateHash& hash, uint64_t feature, T value = T())
+        : value(value), notifier(notifier), field(field), hash(&hash), feature(feature) {
+        hash.Toggle(feature, value);
+    }
+    Observable(const Observable&) = delete;
+
+    operator T() const { return value; }
+    T Get() const { return value; }
+
+    Observable& operator=(T newValue) {
+        if (newValue != value) {
+            if (hash) hash->Change(feature, value, newValue);
+            value = newValue;
+            notifier.Notify(StatBit(field));
+        }
+        return *this;
+    }
+    Observable& operator=(const Observable& other) { return *this = other.value; }
+
+    Observable& operator+=(T amount) { return *this = value + amount; }
+    Observable& operator-=(T amount) { return *this = value - amount; }
+    Observable& operator++() { return *this = value + 1; }
+    T operator++(int) {
+        T previous = value;
+        *this = value + 1;
+        return previous;
+    }
+
+private:
+    T value;
+    StatNotifier& notifier;
+    StatField field;
+    StateHash* hash = nullptr;
+    uint64_t feature = 0;
+};
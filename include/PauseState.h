@@ -0,0 +1,24 @@
+#pragma once
+
+#include "GameState.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+
+// Dims the game and waits. Built once by GamePlayState along with the game
+// and handed back to it on every resume, so pausing builds nothing.
+class PauseState : public GameState {
+public:
+    PauseState();
+    ~PauseState() override = default;
+
+    void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
+    void update(float deltaTime) override;
+    void draw(sf::RenderWindow& window) override;
+    bool isOverlay() const override { return true; }
+
+private:
+    std::shared_ptr<const sf::Font> font;
+    sf::RectangleShape dim;
+    sf::Text title;
+    sf::Text instructions;
+};
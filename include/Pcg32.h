@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// PCG32 (XSH RR) random engine, usable with the <random> distributions. Its
+// whole state is two words, so saves store generators exactly and cheaply,
+// where a std::mt19937 would take 2.5 KB.
+class Pcg32 {
+public:
+    using result_type = uint32_t;
+
+    explicit Pcg32(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        Seed(seed, stream);
+    }
+
+    void Seed(uint64_t seed, uint64_t stream) {
+        state = 0;
+        increment = (stream << 1) | 1;  // Must be odd
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    static uint64_t RandomSeed() {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) | device();
+    }
+    static Pcg32 FromRandomDevice() { return Pcg32(RandomSeed(), std::random_device()()); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        const uint32_t shifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        const uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+    }
+
+    uint64_t GetState() const { return state; }
+    uint64_t GetIncrement() const { return increment; }
+    void Restore(uint64_t savedState, uint64_t savedIncrement) {
+        state = savedState;
+        increment = savedIncrement | 1;
+    }
+
+private:
+    uint64_t state;
+    uint64_t increment;
+};
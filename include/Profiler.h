@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Tracer.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Timed parts of a frame and of the simulation
+enum class ProfilePhase {
+    FRAME,          // Everything between waking up and presenting
+    EVENTS,         // Polling and handling window events
+    UPDATE,         // GameState::update steps
+    DRAW,           // GameState::draw and overlays
+    DISPLAY,        // window.display(), including the vsync wait
+    DRAW_GRID,      // Map view of the gameplay screen
+    COMBAT_LOG,     // Laying out added combat log lines
+    SIMULATION,     // One fixed step on the simulation thread
+    MOVE_MONSTERS,  // Map::MoveMonsters
+    COUNT
+};
+
+// Recent durations per phase in lock-free rings. Scopes only record while
+// profiling is enabled, so the hidden cost is one relaxed load per scope;
+// percentiles are worked out by the reader from a copy of the ring.
+class Profiler {
+public:
+    static constexpr size_t HISTORY = 256;  // Samples kept per phase
+
+    struct PhaseStats {
+        uint32_t p50 = 0;  // Microseconds
+        uint32_t p99 = 0;
+        uint32_t max = 0;
+        size_t samples = 0;
+    };
+
+    static Profiler& Instance();
+
+    void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Any thread
+    void record(ProfilePhase phase, uint32_t microseconds) {
+        Ring& ring = rings[static_cast<size_t>(phase)];
+        const uint64_t index = ring.count.fetch_add(1, std::memory_order_relaxed);
+        ring.samples[index % HISTORY].store(microseconds, std::memory_order_relaxed);
+    }
+
+    PhaseStats getStats(ProfilePhase phase) const;
+    size_t copyHistory(ProfilePhase phase, std::array<uint32_t, HISTORY>& samples) const;  // Oldest first
+    static const char* getPhaseName(ProfilePhase phase);
+
+private:
+    Profiler() = default;
+
+    struct Ring {
+        std::array<std::atomic<uint32_t>, HISTORY> samples{};
+        std::atomic<uint64_t> count{0};
+    };
+
+    std::array<Ring, static_cast<size_t>(ProfilePhase::COUNT)> rings;
+    std::atomic<bool> enabled{false};
+};
+
+// Records the lifetime of the scope under a phase, and as a trace event
+// while a trace is being captured
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase)
+        : phase(phase), profiling(Profiler::Instance().isEnabled()), tracing(Tracer::Instance().isCapturing()) {
+        if (profiling || tracing) begin = Tracer::now();
+    }
+    ~ProfileScope() {
+        if (!profiling && !tracing) return;
+        const int64_t end = Tracer::now();
+        if (profiling) Profiler::Instance().record(phase, static_cast<uint32_t>((end - begin) / 1000));
+        if (tracing) Tracer::Instance().record(Profiler::getPhaseName(phase), begin, end);
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase phase;
+    bool profiling;
+    bool tracing;
+    int64_t begin = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Profiler.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <array>
+#include <string>
+
+// F3 overlay with p50/p99/max per profiled phase and a graph of recent frame
+// times. Toggling it also switches recording on and off; the table is only
+// reformatted a few times a second, so it barely shows up in its own numbers.
+class ProfilerOverlay : public sf::Drawable {
+public:
+    ProfilerOverlay();
+
+    void toggle();
+    bool isVisible() const { return visible; }
+    void update(float deltaTime);
+
+private:
+    static constexpr float REFRESH_SECONDS = 0.25f;
+    static constexpr float GRAPH_HEIGHT = 60.0f;
+    static constexpr float FRAME_BUDGET_MS = 16.7f;  // One frame at 60 Hz
+    static constexpr float GRAPH_MAX_MS = 2 * FRAME_BUDGET_MS;  // Top of the graph
+
+    static const size_t COLUMNS = 4;  // Phase name, p50, p99, max
+
+    void refreshTable();
+    void refreshGraph();
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    std::shared_ptr<const sf::Font> font;
+    std::array<sf::Text, COLUMNS> columns;
+    std::array<std::string, COLUMNS> columnStrings;
+    sf::RectangleShape background;
+    sf::VertexArray graph;
+    sf::RectangleShape budgetLine;  // FRAME_BUDGET_MS on the graph
+    float graphBottom;
+    bool visible;
+    float sinceRefresh;
+};
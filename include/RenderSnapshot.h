@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CombatLogFeed.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything the render thread draws from one simulation state. The
+// simulation fills a free slot of its triple buffer and never touches it again
+// once published; slots are reused, so strings and vectors keep their capacity
+// and a steady game publishes without allocating.
+struct RenderSnapshot {
+    static const size_t INVENTORY_SLOTS = 4;
+
+    // Cell flags in the window around the player
+    static const uint8_t WALL = 1;
+    static const uint8_t ITEM = 2;
+
+    struct PlayerStats {
+        std::string name;
+        int x = 0;
+        int y = 0;
+        int level = 1;
+        int health = 0;
+        int maxHealth = 1;
+        int attack = 0;
+        int totalAttack = 0;  // With weapon and strength buff
+        int buffSeconds = 0;  // Whole seconds left on the strength buff, 0 without one
+        bool hasStrengthBuff = false;
+        bool wounded = false;
+        int defense = 0;
+        int speed = 0;
+        int avoidance = 0;
+        int experience = 0;
+    };
+
+    struct EnemyStats {
+        std::string name;
+        bool boss = false;
+        int health = 0;
+        int maxHealth = 1;
+        int attack = 0;
+        int defense = 0;
+        int speed = 0;
+    };
+
+    // An enemy inside the cell window
+    struct EnemyMarker {
+        int x = 0;
+        int y = 0;
+        bool boss = false;
+        float healthFraction = 1.0f;
+        std::string name;
+    };
+
+    uint64_t inputsConsumed = 0;  // Input events the simulation has finished handling
+    bool animating = false;       // The dice roll or a timed effect is still running
+
+    PlayerStats player;
+    std::array<std::string, INVENTORY_SLOTS> inventory;  // Item names, empty for a free slot
+    int equippedSlot = -1;
+
+    bool inCombat = false;
+    EnemyStats enemy;  // Only meaningful in combat
+
+    int characterClass = 0;  // Changes when a save of another class is loaded
+    int diceValue = 1;
+    bool gameOver = false;
+    bool victory = false;
+    bool returnToMenu = false;
+
+    // Map state; cells are only copied for a window around the player that
+    // covers everything the camera can show
+    int mapWidth = 0;
+    int mapHeight = 0;
+    unsigned wallRevision = 0;
+    bool bossRevealed = false;
+    bool itemsRevealed = false;
+    bool monstersRevealed = false;
+    int windowLeft = 0;
+    int windowTop = 0;
+    int windowWidth = 0;
+    int windowHeight = 0;
+    std::vector<uint8_t> cells;  // Row-major WALL/ITEM flags of the window
+    std::vector<EnemyMarker> enemies;
+
+    CombatLogFeed log;
+
+    uint8_t cellFlags(int x, int y) const {
+        const int column = x - windowLeft;
+        const int row = y - windowTop;
+        if (column < 0 || row < 0 || column >= windowWidth || row >= windowHeight) return 0;
+        return cells[static_cast<size_t>(row) * windowWidth + column];
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Desync check. With FIGHTGPT_REPLAY=<file>, a run whose file does not exist
+// yet is recorded: the seeds it was generated from, every key press with the
+// fixed step of its turn it was handled at, and the state hash at the end of
+// each turn. A run started while the file exists plays those keys back at the
+// same steps instead of taking input, compares its hash at the end of each
+// turn and reports the first turn that came out differently.
+//
+// F5 and F8 are replayed too, against a save file of the replay's own (see
+// getSavePath()), so a replay never touches the player's save. Runs are
+// generated through std::uniform_int_distribution, whose output differs
+// between standard libraries, so a replay only matches on a build using the
+// same standard library as the recording.
+class ReplayLog {
+public:
+    enum class Mode {
+        OFF,
+        RECORDING,
+        REPLAYING
+    };
+
+    // What a run is generated from
+    struct Start {
+        int32_t characterClass = 0;
+        int32_t mapWidth = 0;
+        int32_t mapHeight = 0;
+        uint64_t mapSeed = 0;
+        uint64_t diceSeed = 0;
+    };
+
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t NO_STEP = UINT32_MAX;
+
+    static const char* configuredPath();
+
+    ReplayLog() = default;
+    ~ReplayLog() { close(); }
+    ReplayLog(const ReplayLog&) = delete;
+    ReplayLog& operator=(const ReplayLog&) = delete;
+
+    // Records to `path`, or replays the run it holds, replacing `start` with the recorded one
+    void open(const std::string& path, Start& start);
+    void close();
+    Mode getMode() const { return mode; }
+
+    // Where saves and loads go while recording or replaying: beside the
+    // replay file, and removed when the run starts, so F8 before any F5 fails
+    // in both runs alike
+    const std::string& getSavePath() const { return savePath; }
+
+    // Recording; steps count from the end of the previous turn
+    void recordKey(uint32_t step, int key);
+
+    // Replaying. nextKey() hands out the keys due by `step` one by one;
+    // getNextStep() is the step of the next key or turn end, NO_STEP once the
+    // replay is over.
+    bool nextKey(uint32_t step, int& key);
+    uint32_t getNextStep() const;
+    bool isTurnEndAt(uint32_t step) const;
+
+    // Both modes: records the turn's hash, or checks it against the recorded one
+    void endTurn(uint32_t step, uint64_t hash);
+
+private:
+    static constexpr int32_t TURN_END = -1;
+
+    struct Header {
+        char magic[4];  // "FGRP"
+        uint32_t version;
+        int32_t characterClass;
+        int32_t mapWidth;
+        int32_t mapHeight;
+        uint32_t reserved;
+        uint64_t mapSeed;
+        uint64_t diceSeed;
+    };
+
+    struct Entry {
+        uint32_t step;
+        int32_t key;    // TURN_END for the end of a turn
+        uint64_t hash;  // State hash after the turn, 0 for keys
+    };
+
+    static_assert(sizeof(Header) == 40, "Replay header layout changed");
+    static_assert(sizeof(Entry) == 16, "Replay entry layout changed");
+
+    void write(const Entry& entry);
+    void finishReplay();
+
+    Mode mode = Mode::OFF;
+    std::string path;
+    std::string savePath;
+    FILE* output = nullptr;
+    MappedFile input;
+    const Entry* entries = nullptr;
+    size_t entryCount = 0;
+    size_t nextEntry = 0;
+    uint64_t turn = 0;
+    uint64_t firstDivergedTurn = 0;  // 0 while every turn has matched
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "GameLogic.h"
+#include "SaveGame.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Turn history for undoing turns. A committed turn keeps only what changed
+// since the one before, as 8-byte records that flip the bits of one field of
+// the tracked state (a character's stats, position, inventory or an effect;
+// an item on a map cell; the reveal flags and generators). Flipping is its own
+// inverse, so the same records step a turn back or forward. Records and turns
+// sit in fixed rings where the oldest drop off, and a keyframe of the whole
+// state every KEYFRAME_INTERVAL turns bounds how many records a long rewind
+// has to replay.
+class RewindBuffer {
+public:
+    static constexpr size_t TURN_CAPACITY = 4096;
+    static constexpr size_t RECORD_CAPACITY = 65536;  // 512 KB of records
+    static constexpr uint64_t KEYFRAME_INTERVAL = 64;
+
+    // Starts a new history at the current state; after a new or loaded map
+    void Reset(const Character& player, const Map& map, const SaveGame::Run& run);
+
+    // Cells whose item may have changed, taken from the map before it clears them
+    void NoteChangedCells(const std::vector<std::pair<int, int>>& cells);
+
+    // Stores everything changed since the last turn as a new turn; false when nothing changed
+    bool CommitTurn(const Character& player, const Map& map, const SaveGame::Run& run);
+
+    // Puts the game back by up to `turns` turns without simulating anything;
+    // changes not yet committed count as the latest turn. Returns the turns undone.
+    int Rewind(int turns, Character& player, Map& map, SaveGame::Run& run);
+
+    size_t GetTurnCount() const { return static_cast<size_t>(currentTurn - firstTurn); }  // Turns that can be undone
+
+private:
+    // Fields of a character, each one 32-bit word of its EntityState
+    enum EntityField : uint8_t {
+        HEALTH,
+        MAX_HEALTH,
+        ATTACK,
+        DEFENSE,
+        SPEED,
+        AVOIDANCE,
+        LEVEL,
+        EXPERIENCE,
+        POSITION,   // x | y << 16
+        FLAGS,      // ON_MAP | ABILITY_USED
+        INVENTORY,  // One byte per slot: catalog id + 1, 0 for a free slot
+        EQUIPPED,   // Inventory slot + 1, 0 when unarmed
+        EFFECTS,    // Two words per effect type: magnitude << 1 | active, ticks left << 1 | clock
+        ENTITY_FIELD_COUNT = EFFECTS + 2 * static_cast<int>(StatusEffectType::COUNT)
+    };
+
+    enum RunField : uint8_t {
+        REVEALED,  // Boss, items, monsters
+        MAP_RNG_LOW,
+        MAP_RNG_HIGH,
+        DICE_RNG_LOW,
+        DICE_RNG_HIGH,
+        RUN_FIELD_COUNT
+    };
+
+    // Record fields: an EntityField, RUN_FIELDS + RunField, or ITEM_CELL. Cell
+    // indices take the 24 target bits, enough for 4096x4096 maps.
+    static constexpr uint8_t RUN_FIELDS = 32;
+    static constexpr uint8_t ITEM_CELL = 64;
+
+    using EntityState = std::array<uint32_t, ENTITY_FIELD_COUNT>;
+    using RunState = std::array<uint32_t, RUN_FIELD_COUNT>;
+
+    struct State {
+        std::vector<EntityState> entities;            // The player, then the map's enemies
+        RunState run{};
+        std::unordered_map<uint32_t, uint8_t> items;  // Cell index -> catalog id
+    };
+
+    struct Record {
+        uint32_t key;    // Target << 8 | field; the target is an entity or cell index
+        uint32_t flips;  // Old value XOR new value
+    };
+
+    struct Turn {
+        uint64_t firstRecord;  // Counted since the reset, not a ring index
+        uint32_t recordCount;
+    };
+
+    struct Keyframe {
+        uint64_t turn;  // The state after this turn
+        State state;
+    };
+
+    static EntityState CaptureEntity(const Character& character, const Map& map);
+    static RunState CaptureRun(const Map& map, const SaveGame::Run& run);
+    static uint8_t CaptureItem(const Map& map, uint32_t cell);
+
+    void Append(uint32_t target, uint8_t field, uint32_t flips);
+    void Flip(const Record& record);
+    void DropOldest();
+    void Restore(Character& player, Map& map, SaveGame::Run& run);
+
+    State state;  // As of the last committed turn
+    int mapWidth = 0;
+    std::vector<uint32_t> changedCells;
+    std::vector<Record> records;
+    std::vector<Turn> turns;
+    std::deque<Keyframe> keyframes;
+    uint64_t recordCount = 0;  // Records written since the reset
+    uint64_t firstTurn = 0;    // Oldest state that can still be restored
+    uint64_t currentTurn = 0;
+
+    // Filled in by Flip() and consumed by Restore()
+    std::vector<uint32_t> touchedFields;  // Per entity, one bit per EntityField
+    std::vector<uint32_t> touchedCells;
+    bool runTouched = false;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "GameLogic.h"
+#include "Pcg32.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Binary snapshot of a run: the player, the whole map and every generator it
+// draws from. The file is a fixed header followed by 8-byte aligned sections
+// of fixed-size records (walls packed one bit per cell), so loading maps the
+// file, checks the header and reads the records where they lie; only names and
+// item ids need fixing up into live objects. Integers are little-endian, which
+// SaveGame.cpp checks at compile time.
+class SaveGame {
+public:
+    static const char* const DEFAULT_PATH;
+    static constexpr uint32_t VERSION = 2;
+
+    // What the simulation keeps about a run besides the player and the map
+    struct Run {
+        int characterClass = 0;
+        bool bossRevealed = false;
+        bool itemsRevealed = false;
+        bool monstersRevealed = false;
+        Pcg32 diceRng;
+    };
+
+    // Neither leaves anything half done: a failed write keeps the previous
+    // save, and a failed read leaves the outputs untouched.
+    static bool Write(const std::string& path, const Character& player, const Map& map, const Run& run);
+    static bool Read(const std::string& path, std::unique_ptr<Character>& player, std::unique_ptr<Map>& map,
+                     Run& run);
+};
@@ -0,0 +1,66 @@
+// Generated by bake_atlas.py, do not edit.
+#pragma once
+
+namespace SpriteAtlas {
+
+constexpr const char* PAGE_PATH = "assets/atlas/sprites.png";
+constexpr unsigned PAGE_WIDTH = 1024;
+constexpr unsigned PAGE_HEIGHT = 892;
+
+enum class Sprite {
+    MAP_BACKGROUND,
+    MAP_WALL,
+    MAP_KNIGHT,
+    MAP_MAGE,
+    MAP_ARCHER,
+    MAP_MONSTER,
+    MAP_BOSS,
+    MAP_ITEM,
+    PORTRAIT_KNIGHT,
+    PORTRAIT_MAGE,
+    PORTRAIT_ARCHER,
+    ICON_SWORD,
+    ICON_HAT,
+    ICON_BOW,
+    HUD_SWORD,
+    HUD_HAT,
+    HUD_BOW,
+    DICE,
+    LOGO,
+    SOLID,
+    COUNT
+};
+
+struct Rect {
+    int left;
+    int top;
+    int width;
+    int height;
+};
+
+constexpr Rect RECTS[] = {
+    {0, 0, 600, 600},  // MAP_BACKGROUND
+    {952, 601, 40, 40},  // MAP_WALL
+    {0, 852, 40, 40},  // MAP_KNIGHT
+    {41, 852, 40, 40},  // MAP_MAGE
+    {82, 852, 40, 40},  // MAP_ARCHER
+    {164, 852, 30, 36},  // MAP_MONSTER
+    {294, 852, 15, 15},  // MAP_BOSS
+    {123, 852, 40, 40},  // MAP_ITEM
+    {0, 601, 250, 250},  // PORTRAIT_KNIGHT
+    {251, 601, 250, 250},  // PORTRAIT_MAGE
+    {502, 601, 250, 250},  // PORTRAIT_ARCHER
+    {805, 601, 48, 48},  // ICON_SWORD
+    {854, 601, 48, 48},  // ICON_HAT
+    {903, 601, 48, 48},  // ICON_BOW
+    {195, 852, 32, 32},  // HUD_SWORD
+    {228, 852, 32, 32},  // HUD_HAT
+    {261, 852, 32, 32},  // HUD_BOW
+    {753, 601, 51, 60},  // DICE
+    {601, 0, 300, 300},  // LOGO
+    {310, 852, 3, 3},  // SOLID
+};
+
+constexpr const Rect& GetRect(Sprite sprite) { return RECTS[static_cast<int>(sprite)]; }
+
+}  // namespace SpriteAtlas
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TextCache.h"
+#include <SFML/Graphics.hpp>
+
+// Draw calls and quads submitted in one frame
+struct RenderStats {
+    unsigned drawCalls = 0;
+    unsigned quads = 0;
+};
+
+// Collects textured quads that share one texture and submits them with a
+// single draw call. clear() keeps the vertex storage, so refilling a batch
+// every frame does not allocate once it has reached its working size.
+class SpriteBatch {
+public:
+    SpriteBatch() : vertices(sf::Triangles), texture(nullptr) {}
+
+    void setTexture(const sf::Texture* batchTexture) { texture = batchTexture; }
+    void clear() { vertices.clear(); }
+
+    void addQuad(const sf::FloatRect& bounds, const sf::FloatRect& textureRect, const sf::Color& color = sf::Color::White);
+
+    // Glyph quads of a line laid out by a TextCache; the font's page texture
+    // for that character size must be the batch texture
+    void addText(const TextLayout& layout, const sf::Vector2f& position, const sf::Color& color);
+
+    size_t getQuadCount() const { return vertices.getVertexCount() / 6; }
+    void draw(sf::RenderTarget& target, RenderStats& stats, sf::RenderStates states = sf::RenderStates::Default) const;
+
+private:
+    sf::VertexArray vertices;
+    const sf::Texture* texture;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Head and tail only ever grow; the slot is the index modulo the
+// power-of-two capacity. push() fails instead of waiting when the queue is
+// full, so neither side can block the other.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer thread only
+    bool push(const T& value) {
+        const size_t writeIndex = tail.load(std::memory_order_relaxed);
+        if (writeIndex - head.load(std::memory_order_acquire) == Capacity) return false;
+        slots[writeIndex & (Capacity - 1)] = value;
+        tail.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool pop(T& value) {
+        const size_t readIndex = head.load(std::memory_order_relaxed);
+        if (readIndex == tail.load(std::memory_order_acquire)) return false;
+        value = slots[readIndex & (Capacity - 1)];
+        head.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Kept on separate cache lines so the two threads do not contend
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    std::array<T, Capacity> slots{};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Zobrist-style hash of an object's state. Every feature (a stat, a cell's
+// wall, ...) contributes a 64-bit key made from its id and current value, and
+// the hash is the XOR of all of them, so changing a feature XORs its old key
+// out and its new one in; the hash follows the state and is never recomputed.
+// A value of 0 contributes nothing, so an empty object hashes to 0.
+class StateHash {
+public:
+    // Stands in for a table of random keys, which would need one entry per
+    // possible value of every stat
+    static constexpr uint64_t Key(uint64_t feature, int64_t value) {
+        return value == 0 ? 0 : Mix(Mix(feature + GOLDEN_RATIO) ^ static_cast<uint64_t>(value));
+    }
+
+    // Folds an object's hash into a larger state under the object's slot, so
+    // two objects trading states change the result
+    static constexpr uint64_t Combine(uint64_t hash, uint64_t slot) {
+        return Mix(hash ^ Mix(slot * GOLDEN_RATIO + GOLDEN_RATIO));
+    }
+
+    void Change(uint64_t feature, int64_t oldValue, int64_t newValue) {
+        if (oldValue != newValue) value ^= Key(feature, oldValue) ^ Key(feature, newValue);
+    }
+    void Toggle(uint64_t feature, int64_t featureValue) { value ^= Key(feature, featureValue); }  // In or out
+
+    uint64_t Get() const { return value; }
+
+private:
+    static constexpr uint64_t GOLDEN_RATIO = 0x9e3779b97f4a7c15ULL;
+
+    // splitmix64 finalizer
+    static constexpr uint64_t Mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t value = 0;
+};
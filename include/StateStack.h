@@ -0,0 +1,27 @@
+#pragma once
+
+#include "GameState.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+
+// The screens in play, bottom to top. Only the top state gets input and
+// update steps; the ones below are suspended with everything they built, so
+// popping back to them costs nothing. Transitions the top state asks for are
+// applied between steps.
+class StateStack {
+public:
+    void push(std::unique_ptr<GameState> state);
+    bool applyTransition();  // True if the top state changed
+
+    bool isEmpty() const { return states.empty(); }
+    GameState& top() { return *states.back(); }
+
+    // Overlays on top are drawn over the nearest state that is not one
+    void draw(sf::RenderWindow& window);
+
+private:
+    void pop(size_t count);
+
+    std::vector<std::unique_ptr<GameState>> states;
+};
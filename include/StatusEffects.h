@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class Character;
+class EffectList;
+
+enum class StatusEffectType {
+    WOUNDED,        // Critical miss: bleeds every turn until healed by winning or escaping
+    BURN,           // Mage fireball: burns every turn
+    RAGE,           // Knight: next attack is a guaranteed critical hit
+    HUNTERS_MARK,   // Archer: magnitude counts the remaining guaranteed hits
+    STRENGTH_BUFF,  // Strength potion: magnitude is added to attack
+    COUNT
+};
+
+enum class EffectClock {
+    TURNS,
+    SECONDS
+};
+
+enum class StackingRule {
+    REFRESH,        // Reapplying replaces the magnitude and restarts the duration
+    STACK,          // Reapplying adds to the magnitude (up to maxMagnitude) and restarts the duration
+    KEEP_EXISTING   // Reapplying while active does nothing
+};
+
+class EffectDuration {
+public:
+    static EffectDuration Turns(int turns) { return EffectDuration(EffectClock::TURNS, turns); }
+    static EffectDuration Seconds(float seconds);
+    static EffectDuration Permanent() { return EffectDuration(EffectClock::TURNS, 0); }
+    static EffectDuration FromTicks(EffectClock clock, uint64_t ticks) { return EffectDuration(clock, ticks); }
+
+    EffectClock GetClock() const { return clock; }
+    uint64_t GetTicks() const { return ticks; }  // 0 means the effect never expires on its own
+
+private:
+    EffectDuration(EffectClock clock, uint64_t ticks) : clock(clock), ticks(ticks) {}
+    EffectClock clock;
+    uint64_t ticks;
+};
+
+struct StatusEffect {
+    bool active = false;
+    int magnitude = 0;
+};
+
+struct StatusEffectDefinition {
+    const char* name;
+    StackingRule stacking;
+    int maxMagnitude;
+    EffectClock tickClock;
+    uint64_t tickInterval;  // In tickClock units, 0 for effects without a tick callback
+    void (*onTick)(Character& owner, const StatusEffect& effect);
+};
+
+const StatusEffectDefinition& GetStatusEffectDefinition(StatusEffectType type);
+
+// Hierarchical timing wheel (4 levels of 64 slots). Scheduling and cancelling
+// are O(1); advancing costs one slot visit per tick plus the timers that expire,
+// independent of how many timers are pending.
+class TimingWheel {
+public:
+    struct Timer {
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+        uint64_t deadline = 0;
+        bool IsScheduled() const { return next != nullptr; }
+    };
+
+    TimingWheel();
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    void Schedule(Timer& timer, uint64_t delay);
+    void Cancel(Timer& timer);
+    uint64_t Now() const { return now; }
+    size_t GetScheduledCount() const { return scheduledCount; }
+
+    // Moves time forward tick by tick, calling onExpire(timer) for each timer
+    // whose deadline is reached. Callbacks may schedule or cancel timers.
+    template <typename Callback>
+    void Advance(uint64_t ticks, Callback&& onExpire);
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const uint64_t SLOTS = 1u << SLOT_BITS;
+
+    void Insert(Timer& timer);
+    void Cascade(int level);
+    void Link(Timer& head, Timer& timer);
+    void Unlink(Timer& timer);
+
+    std::array<std::array<Timer, SLOTS>, LEVELS> slots;
+    uint64_t now;
+    size_t scheduledCount;
+};
+
+// Owns the turn and seconds wheels shared by every EffectList.
+class StatusEffectScheduler {
+public:
+    static constexpr float SECONDS_PER_TICK = 0.01f;
+
+    static StatusEffectScheduler& Instance();
+
+    void AdvanceTurn();
+    void AdvanceTime(float deltaTime);
+
+    TimingWheel& GetWheel(EffectClock clock) { return clock == EffectClock::TURNS ? turnWheel : timeWheel; }
+    float GetPendingSeconds() const { return pendingSeconds; }
+
+private:
+    StatusEffectScheduler() : pendingSeconds(0.0f) {}
+    static void OnTimer(TimingWheel::Timer& timer);
+
+    TimingWheel turnWheel;
+    TimingWheel timeWheel;
+    float pendingSeconds;
+};
+
+// Per-entity effect storage: one slot per effect type, each with an expiry and
+// a tick timer registered on the scheduler's wheels.
+class EffectList {
+public:
+    explicit EffectList(Character& owner) : owner(owner) {}
+    ~EffectList() { Clear(); }
+    EffectList(const EffectList&) = delete;
+    EffectList& operator=(const EffectList&) = delete;
+
+    void Apply(StatusEffectType type, int magnitude, EffectDuration duration);
+    void Remove(StatusEffectType type);
+    void Clear();
+
+    bool Has(StatusEffectType type) const { return slot(type).effect.active; }
+    int GetMagnitude(StatusEffectType type) const;
+    void ConsumeMagnitude(StatusEffectType type, int amount = 1);  // Removes the effect at 0
+    float GetRemainingSeconds(StatusEffectType type) const;
+    int GetRemainingTurns(StatusEffectType type) const;
+    EffectDuration GetRemainingDuration(StatusEffectType type) const;  // Permanent() when it never expires
+
+private:
+    friend class StatusEffectScheduler;
+
+    struct EffectTimer : TimingWheel::Timer {
+        EffectList* list = nullptr;
+        StatusEffectType type = StatusEffectType::COUNT;
+        bool isTick = false;
+        EffectClock clock = EffectClock::TURNS;
+    };
+
+    struct Slot {
+        StatusEffect effect;
+        EffectTimer expiry;
+        EffectTimer tick;
+    };
+
+    Slot& slot(StatusEffectType type) { return slots[static_cast<size_t>(type)]; }
+    const Slot& slot(StatusEffectType type) const { return slots[static_cast<size_t>(type)]; }
+    void schedule(EffectTimer& timer, StatusEffectType type, EffectClock clock, uint64_t delay, bool isTick);
+    void cancel(EffectTimer& timer);
+    void onTimer(EffectTimer& timer);
+    void rehash(StatusEffectType type, const StatusEffect& before);  // After the slot's effect changed
+
+    Character& owner;
+    std::array<Slot, static_cast<size_t>(StatusEffectType::COUNT)> slots;
+};
+
+template <typename Callback>
+void TimingWheel::Advance(uint64_t ticks, Callback&& onExpire) {
+    for (uint64_t i = 0; i < ticks; ++i) {
+        ++now;
+
+        // Pull timers from coarser levels down when their range comes up
+        for (int level = 1; level < LEVELS; ++level) {
+            if ((now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+            Cascade(level);
+        }
+
+        // Detach the due slot so callbacks can freely reschedule
+        Timer& head = slots[0][now & (SLOTS - 1)];
+        if (head.next == &head) continue;
+        Timer due;
+        due.next = head.next;
+        due.prev = head.prev;
+        due.next->prev = &due;
+        due.prev->next = &due;
+        head.next = head.prev = &head;
+
+        while (due.next != &due) {
+            Timer& timer = *due.next;
+            Unlink(timer);
+            if (timer.deadline > now) {
+                Insert(timer);  // Far-future timer clamped into the top level
+            } else {
+                onExpire(timer);
+            }
+        }
+    }
+}
@@ -14,12 +14,13 @@ public:
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool isAnimating() const override { return true; }  // Text fades in, then the continue prompt pulses
 
 private:
     void generateStory();
     void formatText();
 
-    sf::Font font;
+    std::shared_ptr<const sf::Font> font;
     sf::Text storyText;
     sf::Text continueText;
     sf::RectangleShape background;
@@ -30,4 +31,8 @@ private:
     float pulseEffect;
     float continueTextDelay;
     std::string bossName;
+
+    // Values at the previous step, blended with the current ones when drawn
+    float previousFadeIn = 0.0f;
+    float previousPulse = 0.0f;
 }; 
\ No newline at end of file
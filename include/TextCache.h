@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One glyph of a laid-out line, relative to the text position
+struct GlyphQuad {
+    sf::FloatRect bounds;
+    sf::FloatRect textureRect;  // In pixels on the font page for the character size
+};
+
+using TextLayout = std::vector<GlyphQuad>;
+
+// Laid-out text kept between frames, keyed by (font, character size, string).
+// A frame that shows the same strings as the last one does no layout work and
+// no allocation: lookups take a string_view and only a miss builds a key.
+// Each state owns its cache next to its font, so a font never outlives its entries.
+class TextCache {
+public:
+    static const size_t MAX_ENTRIES = 256;
+    static const uint64_t EVICT_AFTER_FRAMES = 120;
+
+    // Retained sf::Text for the key; the caller sets position and colour,
+    // neither of which triggers a new layout
+    sf::Text& get(const sf::Font& font, unsigned characterSize, std::string_view string);
+
+    // Glyph quads for a single line, for drawing through a SpriteBatch
+    const TextLayout& layout(const sf::Font& font, unsigned characterSize, std::string_view string);
+
+    // Call once per frame; entries unused for a while are dropped once the cache is full
+    void nextFrame() { ++frame; }
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Key {
+        const sf::Font* font;
+        unsigned characterSize;
+        std::string string;
+    };
+
+    struct KeyView {
+        const sf::Font* font;
+        unsigned characterSize;
+        std::string_view string;
+    };
+
+    struct KeyLess {
+        using is_transparent = void;
+
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            if (a.font != b.font) return std::less<const sf::Font*>()(a.font, b.font);
+            if (a.characterSize != b.characterSize) return a.characterSize < b.characterSize;
+            return std::string_view(a.string) < std::string_view(b.string);
+        }
+    };
+
+    struct Entry {
+        sf::Text text;
+        TextLayout glyphs;
+        bool hasText = false;
+        bool hasGlyphs = false;
+        uint64_t lastUsed = 0;
+    };
+
+    Entry& find(const sf::Font& font, unsigned characterSize, std::string_view string);
+    void evictStale();
+
+    std::map<Key, Entry, KeyLess> entries;
+    uint64_t frame = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Word wrapping from the font's glyph advances and kerning for one character
+// size, measured the way sf::Text places glyphs. Advances and kerning pairs
+// are cached after their first lookup, and a wrap is a single pass over the
+// characters with no sf::Text built to measure anything.
+class TextWrapper {
+public:
+    TextWrapper() = default;
+    TextWrapper(const sf::Font& font, unsigned characterSize) { setFont(font, characterSize); }
+
+    void setFont(const sf::Font& font, unsigned characterSize);  // Drops the cached metrics
+
+    // Appends the lines of text no wider than maxWidth, as views into text.
+    // Breaks at '\n' and at the last space that fits; a word wider than a
+    // whole line is split where it overflows. Spaces at a break are dropped.
+    void wrap(std::string_view text, float maxWidth, std::vector<std::string_view>& lines);
+    std::string wrapToString(std::string_view text, float maxWidth);  // Lines joined with '\n'
+
+private:
+    float advance(unsigned char c);
+    float kerning(unsigned char first, unsigned char second);
+
+    const sf::Font* font = nullptr;
+    unsigned characterSize = 0;
+    std::array<float, 256> advances{};
+    std::array<bool, 256> hasAdvance{};
+    std::unordered_map<unsigned, float> kernings;  // first << 8 | second
+    std::vector<std::string_view> scratch;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "SpriteAtlas.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+
+// The sprite page baked by bake_atlas.py. Every state draws its sprites from
+// this one texture, already resampled to the size they are shown at, so
+// sprites need no scaling and switching states binds no new textures. The
+// page itself is held through the AssetCache like every other texture.
+class TextureAtlas {
+public:
+    static TextureAtlas& Instance();
+
+    bool load();  // Loads the page on first use; later calls are free
+    bool isLoaded() const { return loaded; }
+    void preload();        // Decodes the page in the background so load() does not wait
+    bool isReady() const;  // load() would not wait
+
+    const sf::Texture& getTexture() const { return *texture; }
+    sf::FloatRect getRegion(SpriteAtlas::Sprite sprite) const;
+    sf::FloatRect getSolidRegion() const;  // Centre texel of the white block, for bars and lines
+    void apply(sf::Sprite& sprite, SpriteAtlas::Sprite region) const;
+
+private:
+    TextureAtlas() : loaded(false) {}
+
+    std::shared_ptr<const sf::Texture> texture;
+    bool loaded;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Captures begin and end times of instrumented scopes on every thread and
+// writes them as Chrome trace-event JSON, which chrome://tracing and Perfetto
+// open directly. Capture is started with F4 or FIGHTGPT_TRACE=<file>; while it
+// is off, a scope costs one relaxed atomic load. Events go into a buffer
+// claimed with one atomic add per scope, so recording never locks; a full
+// buffer drops further events until the capture is written.
+class Tracer {
+public:
+    static constexpr size_t CAPACITY = 1 << 18;  // Events per capture
+    static constexpr size_t MAX_THREADS = 16;     // Threads that can be named
+
+    static Tracer& Instance();
+
+    bool isCapturing() const { return capturing.load(std::memory_order_relaxed); }
+    void start();
+    bool stop(const std::string& path);  // Writes the capture; false if the file could not be written
+
+    // Any thread. Names must outlive the capture; string literals are expected.
+    void record(const char* name, int64_t beginNanoseconds, int64_t endNanoseconds);
+    void nameThread(const char* name);  // Labels the calling thread in the trace
+
+    static int64_t now();  // Steady clock in nanoseconds
+
+    // FIGHTGPT_TRACE=<file> captures from startup and writes there on exit;
+    // F4 captures write there too, or to DEFAULT_PATH
+    static const char* configuredPath();
+    static const char* const DEFAULT_PATH;
+
+private:
+    Tracer() = default;
+
+    struct Event {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+        uint32_t thread;
+        uint32_t epoch;  // Capture the scope was recorded for; a late scope can land in the next one
+        std::atomic<bool> ready{false};  // Set once the other fields are written
+    };
+
+    std::unique_ptr<Event[]> events;  // Allocated on the first capture and kept
+    std::atomic<size_t> claimed{0};
+    std::atomic<bool> capturing{false};
+    std::atomic<uint32_t> epoch{0};  // Bumped by every start()
+    int64_t origin = 0;
+    std::array<std::atomic<const char*>, MAX_THREADS> threadNames{};
+};
+
+// Records the lifetime of the scope as one trace event
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), active(Tracer::Instance().isCapturing()) {
+        if (active) begin = Tracer::now();
+    }
+    ~TraceScope() {
+        if (active) Tracer::Instance().record(name, begin, Tracer::now());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    bool active;
+    int64_t begin = 0;
+};
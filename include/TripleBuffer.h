@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free hand-over of whole values from one writer thread to one reader
+// thread. The writer fills back() and publishes it; the reader takes the most
+// recently published value with update() and reads it through front() for as
+// long as it likes. Three slots rotate between writer, reader and the shared
+// middle, so neither side ever waits and a slot is never written while read.
+// Slots are reused, so the writer must overwrite every field it publishes.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer thread only
+    T& back() { return slots[backIndex]; }
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader thread only; returns false when nothing new was published
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;  // Set on the middle index when it holds an unread value
+
+    std::array<T, 3> slots;
+    unsigned backIndex = 0;
+    std::atomic<unsigned> middle{1};
+    unsigned frontIndex = 2;
+};
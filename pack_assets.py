@@ -0,0 +1,74 @@
+"""Packs the assets the game loads at runtime into one archive.
+
+The game memory-maps the archive and finds each file by its path, so startup
+opens one file instead of one per asset. Textures are stored as decoded RGBA
+pixels, ready to upload, so nothing is PNG-decoded at runtime; fonts are
+stored as they are. Layout, all little-endian (see include/AssetArchive.h):
+
+    header   magic 'FGPK', version, entry count, reserved     (16 bytes)
+    entries  name[96], kind, width, height, reserved,
+             offset, size                                    (128 bytes each)
+    payloads each aligned to 16 bytes
+
+Usage: python3 pack_assets.py [output]   (default assets.pak)
+"""
+import glob
+import struct
+import sys
+
+from PIL import Image
+
+MAGIC = b'FGPK'
+VERSION = 1
+NAME_SIZE = 96
+ALIGNMENT = 16
+
+KIND_RAW = 0
+KIND_RGBA = 1
+
+# Only what the game opens; the sprite sources are baked into the atlas page
+TEXTURES = ['assets/atlas/sprites.png']
+FONTS = sorted(glob.glob('assets/fonts/*.ttf'))
+
+
+def load_entries():
+    entries = []
+    for path in TEXTURES:
+        image = Image.open(path).convert('RGBA')
+        entries.append((path, KIND_RGBA, image.width, image.height, image.tobytes()))
+    for path in FONTS:
+        with open(path, 'rb') as font:
+            entries.append((path, KIND_RAW, 0, 0, font.read()))
+    return entries
+
+
+def align(offset):
+    return (offset + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def write_archive(output, entries):
+    header = struct.pack('<4sIII', MAGIC, VERSION, len(entries), 0)
+    offset = align(len(header) + 128 * len(entries))
+    table = b''
+    layout = []
+    for name, kind, width, height, payload in entries:
+        encoded = name.encode('utf-8')
+        if len(encoded) >= NAME_SIZE:
+            sys.exit('Asset path too long for the archive: %s' % name)
+        table += struct.pack('<%dsIIIIQQ' % NAME_SIZE, encoded, kind, width, height, 0, offset, len(payload))
+        layout.append((offset, payload))
+        offset = align(offset + len(payload))
+
+    with open(output, 'wb') as archive:
+        archive.write(header)
+        archive.write(table)
+        for position, payload in layout:
+            archive.write(b'\0' * (position - archive.tell()))
+            archive.write(payload)
+    return offset
+
+
+output = sys.argv[1] if len(sys.argv) > 1 else 'assets.pak'
+entries = load_entries()
+size = write_archive(output, entries)
+print('Packed %d assets into %s (%.1f MB)' % (len(entries), output, size / (1024 * 1024)))
@@ -0,0 +1,36 @@
+#include "AllocationCounter.h"
+
+#ifdef FIGHTGPT_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread, so the render thread's figure leaves out the simulation, logger
+// and asset threads; a plain integer needs no dynamic TLS initialisation
+thread_local uint64_t allocationCount = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+uint64_t AllocationCounter::GetCount() { return allocationCount; }
+
+#else
+
+uint64_t AllocationCounter::GetCount() { return 0; }
+
+#endif
@@ -0,0 +1,78 @@
+#include "AssetArchive.h"
+#include "Logger.h"
+#include <cstring>
+
+namespace {
+// On-disk layout, little-endian; see pack_assets.py
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct TableEntry {
+    char name[96];
+    uint32_t kind;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(Header) == 16, "Header must match pack_assets.py");
+static_assert(sizeof(TableEntry) == 128, "TableEntry must match pack_assets.py");
+
+// The table is read in place as native structs, so only little-endian targets
+// read what pack_assets.py wrote (MSVC targets always are)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The asset archive is little-endian; big-endian targets need byte swapping in readTable()"
+#endif
+}
+
+bool AssetArchive::open(const std::string& path) {
+    entries.clear();
+    if (!file.open(path)) return false;
+
+    if (!readTable()) {
+        Logger::error("Asset archive is damaged or from another version, rerun pack_assets.py: ", path);
+        entries.clear();
+        file.close();
+        return false;
+    }
+    Logger::info("Mapped asset archive ", path, " with ", entries.size(), " assets");
+    return true;
+}
+
+bool AssetArchive::readTable() {
+    const uint8_t* base = file.data();
+    const size_t size = file.size();
+    Header header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, "FGPK", 4) != 0 || header.version != VERSION) return false;
+    if (header.count > (size - sizeof(header)) / sizeof(TableEntry)) return false;
+
+    for (uint32_t i = 0; i < header.count; ++i) {
+        TableEntry table;
+        std::memcpy(&table, base + sizeof(header) + i * sizeof(TableEntry), sizeof(table));
+        if (std::memchr(table.name, '\0', NAME_SIZE) == nullptr) return false;
+        if (table.offset > size || table.size > size - table.offset) return false;
+
+        Entry entry;
+        entry.kind = static_cast<Kind>(table.kind);
+        entry.width = table.width;
+        entry.height = table.height;
+        entry.data = base + table.offset;
+        entry.size = static_cast<size_t>(table.size);
+        if (entry.kind == Kind::RGBA && uint64_t(entry.width) * entry.height * 4 != table.size) return false;
+        entries.emplace(table.name, entry);
+    }
+    return true;
+}
+
+const AssetArchive::Entry* AssetArchive::find(const std::string& name) const {
+    auto it = entries.find(name);
+    return it != entries.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,209 @@
+#include "AssetCache.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+// sf::Font reads glyphs from its source as they are first drawn, so a font
+// loaded from memory keeps the file contents alongside it (packed fonts stay
+// in the mapped archive instead)
+struct FontAsset {
+    std::vector<char> data;
+    sf::Font font;
+};
+
+std::vector<char> readFile(const std::string& path) {
+    TraceScope scope("Read font");
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::unique_ptr<sf::Image> decodeImage(const std::string& path) {
+    TraceScope scope("Decode image");
+    auto image = std::make_unique<sf::Image>();
+    if (!image->loadFromFile(path)) return nullptr;
+    return image;
+}
+
+std::shared_ptr<sf::Font> makeFont(std::vector<char> data, const std::string& path) {
+    auto asset = std::make_shared<FontAsset>();
+    asset->data = std::move(data);
+    if (asset->data.empty() || !asset->font.loadFromMemory(asset->data.data(), asset->data.size())) {
+        Logger::error("Failed to load font: ", path);
+    }
+    // Shares the asset's reference count, so releaseUnused() still sees the users
+    return std::shared_ptr<sf::Font>(asset, &asset->font);
+}
+
+std::shared_ptr<sf::Font> makePackedFont(const AssetArchive::Entry& entry, const std::string& path) {
+    auto asset = std::make_shared<FontAsset>();
+    if (entry.kind != AssetArchive::Kind::RAW || !asset->font.loadFromMemory(entry.data, entry.size)) {
+        Logger::error("Failed to load font: ", path);
+    }
+    return std::shared_ptr<sf::Font>(asset, &asset->font);
+}
+
+std::shared_ptr<sf::Texture> makePackedTexture(const AssetArchive::Entry& entry, const std::string& path) {
+    TraceScope scope("Upload texture");
+    auto texture = std::make_shared<sf::Texture>();
+    if (entry.kind != AssetArchive::Kind::RGBA || !texture->create(entry.width, entry.height)) {
+        Logger::error("Failed to load texture: ", path);
+        return texture;
+    }
+    texture->update(entry.data);
+    return texture;
+}
+
+std::shared_ptr<sf::Texture> makeTexture(const sf::Image* image, const std::string& path) {
+    TraceScope scope("Upload texture");
+    auto texture = std::make_shared<sf::Texture>();
+    if (!image || !texture->loadFromImage(*image)) {
+        Logger::error("Failed to load texture: ", path);
+    }
+    return texture;
+}
+
+template <typename T>
+bool isReady(const std::future<T>& future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+}
+
+AssetCache& AssetCache::Instance() {
+    // Never destroyed so cached textures outlive every state and the window,
+    // and packed fonts keep reading from the mapping
+    static AssetCache* cache = new AssetCache();
+    return *cache;
+}
+
+AssetCache::AssetCache() {
+    const char* loose = std::getenv("FIGHTGPT_LOOSE_ASSETS");
+    if (loose && std::strcmp(loose, "1") == 0) {
+        Logger::info("Loading loose asset files");
+        return;
+    }
+    if (!archive.open(AssetArchive::DEFAULT_PATH)) {
+        Logger::info("No asset archive, loading loose asset files");
+    }
+}
+
+std::shared_ptr<const sf::Font> AssetCache::getFont(const std::string& path) {
+    auto it = fonts.find(path);
+    if (it != fonts.end()) return it->second;
+
+    if (const AssetArchive::Entry* packed = archive.find(path)) {
+        return fonts.emplace(path, makePackedFont(*packed, path)).first->second;
+    }
+
+    std::vector<char> data;
+    auto pending = pendingFonts.find(path);
+    if (pending != pendingFonts.end()) {
+        data = pending->second.get();
+        pendingFonts.erase(pending);
+        finishPreload();
+    } else {
+        data = readFile(path);
+    }
+    return fonts.emplace(path, makeFont(std::move(data), path)).first->second;
+}
+
+std::shared_ptr<const sf::Texture> AssetCache::getTexture(const std::string& path) {
+    auto it = textures.find(path);
+    if (it != textures.end()) return it->second;
+
+    if (const AssetArchive::Entry* packed = archive.find(path)) {
+        return textures.emplace(path, makePackedTexture(*packed, path)).first->second;
+    }
+
+    std::unique_ptr<sf::Image> image;
+    auto pending = pendingTextures.find(path);
+    if (pending != pendingTextures.end()) {
+        TraceScope scope("Wait for image");
+        image = pending->second.get();
+        pendingTextures.erase(pending);
+        finishPreload();
+    } else {
+        image = decodeImage(path);
+    }
+    return textures.emplace(path, makeTexture(image.get(), path)).first->second;
+}
+
+void AssetCache::preloadFont(const std::string& path) {
+    if (fonts.count(path) || pendingFonts.count(path) || archive.find(path)) return;
+    startPreload();
+    pendingFonts.emplace(path, std::async(std::launch::async, readFile, path));
+}
+
+void AssetCache::preloadTexture(const std::string& path) {
+    if (textures.count(path) || pendingTextures.count(path) || archive.find(path)) return;
+    startPreload();
+    pendingTextures.emplace(path, std::async(std::launch::async, decodeImage, path));
+}
+
+void AssetCache::startPreload() {
+    if (!isLoading()) {
+        preloadsRequested = 0;
+        preloadsFinished = 0;
+    }
+    ++preloadsRequested;
+}
+
+void AssetCache::finishPreload() {
+    ++preloadsFinished;
+}
+
+void AssetCache::update() {
+    if (!isLoading()) return;
+
+    for (auto it = pendingFonts.begin(); it != pendingFonts.end();) {
+        if (isReady(it->second)) {
+            fonts.emplace(it->first, makeFont(it->second.get(), it->first));
+            it = pendingFonts.erase(it);
+            finishPreload();
+        } else {
+            ++it;
+        }
+    }
+
+    // Uploads block the render thread, so spread them over frames
+    for (auto it = pendingTextures.begin(); it != pendingTextures.end(); ++it) {
+        if (isReady(it->second)) {
+            std::unique_ptr<sf::Image> image = it->second.get();
+            textures.emplace(it->first, makeTexture(image.get(), it->first));
+            pendingTextures.erase(it);
+            finishPreload();
+            break;
+        }
+    }
+}
+
+bool AssetCache::isTextureReady(const std::string& path) const {
+    return textures.count(path) != 0 || archive.find(path) != nullptr;
+}
+
+float AssetCache::getProgress() const {
+    if (!isLoading() || preloadsRequested == 0) return 1.0f;
+    return static_cast<float>(preloadsFinished) / preloadsRequested;
+}
+
+template <typename Asset>
+size_t AssetCache::releaseUnused(AssetMap<Asset>& assets) {
+    size_t released = 0;
+    for (auto it = assets.begin(); it != assets.end();) {
+        if (it->second.use_count() == 1) {
+            it = assets.erase(it);
+            ++released;
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
+
+size_t AssetCache::releaseUnused() {
+    return releaseUnused(fonts) + releaseUnused(textures);
+}
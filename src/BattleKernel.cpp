@@ -0,0 +1,204 @@
+#include "BattleKernel.h"
+#include "GameLogic.h"
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FIGHTGPT_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline uint32_t NextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Maps the top 16 bits of a random word onto [0, range) without a division
+inline int32_t RandomBelow(uint32_t r, int32_t range) {
+    return static_cast<int32_t>(((r >> 16) * static_cast<uint32_t>(range)) >> 16);
+}
+
+size_t StepScalar(BattleBatch& batch, size_t begin, size_t end) {
+    size_t running = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (batch.finished[i]) continue;
+
+        bool aStrikes = batch.turnA[i] != 0;
+        int32_t attack = aStrikes ? batch.attackA[i] : batch.attackB[i];
+        int32_t defense = aStrikes ? batch.defenseB[i] : batch.defenseA[i];
+        int32_t avoidance = aStrikes ? batch.avoidanceB[i] : batch.avoidanceA[i];
+        int32_t& health = aStrikes ? batch.healthB[i] : batch.healthA[i];
+
+        uint32_t avoidRoll = NextRandom(batch.rngState[i]);
+        uint32_t varianceRoll = NextRandom(batch.rngState[i]);
+
+        int32_t damage = 0;
+        if (RandomBelow(avoidRoll, 100) >= avoidance) {
+            // Same formula as Character::TakeDamage
+            float defenseReduction = static_cast<float>(defense) / static_cast<float>(defense + 50);
+            float damageMultiplier = static_cast<float>(RandomBelow(varianceRoll, 30) + 85) / 100.0f;
+            damage = static_cast<int32_t>(static_cast<float>(attack) * (1.0f - defenseReduction) * damageMultiplier);
+            damage = std::max(1, damage);
+        }
+
+        health = std::max(0, health - damage);
+        batch.rounds[i]++;
+        batch.turnA[i] = aStrikes ? 0 : 1;
+        if (health == 0) {
+            batch.finished[i] = 1;
+        } else {
+            running++;
+        }
+    }
+    return running;
+}
+
+#ifdef FIGHTGPT_HAS_AVX2_KERNEL
+
+__attribute__((target("avx2")))
+inline __m256i NextRandom8(__m256i state) {
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+    return state;
+}
+
+__attribute__((target("avx2")))
+inline __m256i RandomBelow8(__m256i r, int32_t range) {
+    return _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(r, 16), _mm256_set1_epi32(range)), 16);
+}
+
+__attribute__((target("avx2")))
+inline __m256i Load8(const std::vector<int32_t>& v, size_t i) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v.data() + i));
+}
+
+__attribute__((target("avx2")))
+inline void Store8(std::vector<int32_t>& v, size_t i, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(v.data() + i), value);
+}
+
+__attribute__((target("avx2")))
+size_t StepAvx2(BattleBatch& batch, size_t lanes) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i fifty = _mm256_set1_epi32(50);
+    const __m256i eightyFive = _mm256_set1_epi32(85);
+    const __m256 oneF = _mm256_set1_ps(1.0f);
+    const __m256 hundredF = _mm256_set1_ps(100.0f);
+
+    size_t running = 0;
+    for (size_t i = 0; i < lanes; i += BattleBatch::LANE_WIDTH) {
+        __m256i finished = Load8(batch.finished, i);
+        __m256i active = _mm256_cmpeq_epi32(finished, zero);
+        if (_mm256_testz_si256(active, active)) continue;  // Whole block already done
+
+        __m256i aStrikes = _mm256_cmpeq_epi32(Load8(batch.turnA, i), one);
+        __m256i healthA = Load8(batch.healthA, i);
+        __m256i healthB = Load8(batch.healthB, i);
+
+        // Pick attacker and defender per lane
+        __m256i attack = _mm256_blendv_epi8(Load8(batch.attackB, i), Load8(batch.attackA, i), aStrikes);
+        __m256i defense = _mm256_blendv_epi8(Load8(batch.defenseA, i), Load8(batch.defenseB, i), aStrikes);
+        __m256i avoidance = _mm256_blendv_epi8(Load8(batch.avoidanceA, i), Load8(batch.avoidanceB, i), aStrikes);
+        __m256i health = _mm256_blendv_epi8(healthA, healthB, aStrikes);
+
+        __m256i rng = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(batch.rngState.data() + i));
+        __m256i avoidRoll = NextRandom8(rng);
+        __m256i varianceRoll = NextRandom8(avoidRoll);
+        __m256i avoided = _mm256_cmpgt_epi32(avoidance, RandomBelow8(avoidRoll, 100));
+
+        // Same formula as Character::TakeDamage, evaluated in the same order
+        __m256 defenseF = _mm256_cvtepi32_ps(defense);
+        __m256 defenseReduction = _mm256_div_ps(defenseF, _mm256_cvtepi32_ps(_mm256_add_epi32(defense, fifty)));
+        __m256 damageMultiplier = _mm256_div_ps(
+            _mm256_cvtepi32_ps(_mm256_add_epi32(RandomBelow8(varianceRoll, 30), eightyFive)), hundredF);
+        __m256 damageF = _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(attack), _mm256_sub_ps(oneF, defenseReduction)),
+                                       damageMultiplier);
+        __m256i damage = _mm256_max_epi32(one, _mm256_cvttps_epi32(damageF));
+        damage = _mm256_andnot_si256(avoided, damage);
+
+        __m256i newHealth = _mm256_max_epi32(zero, _mm256_sub_epi32(health, damage));
+
+        // Finished lanes keep their old values
+        healthA = _mm256_blendv_epi8(healthA, newHealth, _mm256_andnot_si256(aStrikes, active));
+        healthB = _mm256_blendv_epi8(healthB, newHealth, _mm256_and_si256(aStrikes, active));
+        __m256i defeated = _mm256_and_si256(active, _mm256_cmpeq_epi32(newHealth, zero));
+        __m256i nextTurn = _mm256_blendv_epi8(one, zero, aStrikes);
+
+        Store8(batch.healthA, i, healthA);
+        Store8(batch.healthB, i, healthB);
+        Store8(batch.finished, i, _mm256_or_si256(finished, _mm256_and_si256(defeated, one)));
+        Store8(batch.turnA, i, _mm256_blendv_epi8(Load8(batch.turnA, i), nextTurn, active));
+        Store8(batch.rounds, i, _mm256_sub_epi32(Load8(batch.rounds, i), active));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(batch.rngState.data() + i),
+                            _mm256_blendv_epi8(rng, varianceRoll, active));
+
+        __m256i stillRunning = _mm256_andnot_si256(defeated, active);
+        running += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(stillRunning)));
+    }
+    return running;
+}
+
+#endif
+
+}  // namespace
+
+void BattleBatch::Resize(size_t n) {
+    count = n;
+    size_t padded = (n + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH;
+    for (auto* column : {&healthA, &attackA, &defenseA, &avoidanceA,
+                         &healthB, &attackB, &defenseB, &avoidanceB,
+                         &turnA, &rounds}) {
+        column->assign(padded, 0);
+    }
+    finished.assign(padded, 0);
+    std::fill(finished.begin() + n, finished.end(), 1);
+    rngState.assign(padded, 1u);
+}
+
+void BattleBatch::SetLane(size_t lane, Character& a, Character& b, uint32_t seed) {
+    healthA[lane] = a.GetHealth();
+    attackA[lane] = a.GetTotalAttack();
+    defenseA[lane] = a.GetDefense();
+    avoidanceA[lane] = a.GetAvoidance();
+    healthB[lane] = b.GetHealth();
+    attackB[lane] = b.GetTotalAttack();
+    defenseB[lane] = b.GetDefense();
+    avoidanceB[lane] = b.GetAvoidance();
+    turnA[lane] = a.GetSpeed() > b.GetSpeed() ? 1 : 0;  // Same initiative rule as Battle::Fight
+    finished[lane] = (healthA[lane] <= 0 || healthB[lane] <= 0) ? 1 : 0;
+    rounds[lane] = 0;
+    rngState[lane] = seed ? seed : 0x9E3779B9u;  // xorshift must never be seeded with 0
+}
+
+size_t BattleKernel::Step(BattleBatch& batch, Path path) {
+#ifdef FIGHTGPT_HAS_AVX2_KERNEL
+    if (path == Path::AUTO && HasAvx2()) {
+        return StepAvx2(batch, batch.finished.size());
+    }
+#else
+    (void)path;
+#endif
+    return StepScalar(batch, 0, batch.finished.size());
+}
+
+void BattleKernel::Resolve(BattleBatch& batch, int maxRounds, Path path) {
+    for (int round = 0; round < maxRounds; ++round) {
+        if (Step(batch, path) == 0) {
+            break;
+        }
+    }
+}
+
+bool BattleKernel::HasAvx2() {
+#ifdef FIGHTGPT_HAS_AVX2_KERNEL
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
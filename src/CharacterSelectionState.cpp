@@ -1,56 +1,39 @@
 #include "CharacterSelectionState.h"
 #include "GamePlayState.h"
+#include "AssetCache.h"
 #include "Logger.h"
+#include "TextureAtlas.h"
 #include <sstream>
 
 CharacterSelectionState::CharacterSelectionState(const std::string& name) 
     : selectedOption(0), playerName(name) {
     
-    if (!font.loadFromFile("assets/fonts/Jersey15-Regular.ttf")) {
-        Logger::error("Failed to load font!");
+    font = AssetCache::Instance().getFont(AssetCache::DEFAULT_FONT_PATH);
+
+    TextureAtlas& atlas = TextureAtlas::Instance();
+    if (!atlas.load()) {
         return;
     }
 
-    // Load class icons
-    std::vector<std::string> iconPaths = {
-        "assets/icons/sword.png",
-        "assets/icons/hat.png",
-        "assets/icons/bow.png"
-    };
-
-    // Load character images
-    std::vector<std::string> characterPaths = {
-        "assets/characters/knight.png",
-        "assets/characters/mage.png",
-        "assets/characters/archer.png"
-    };
+    // Class icons baked at 48x48 and character images at 250 pixels for the log panel
+    const std::array<SpriteAtlas::Sprite, 3> icons = {{
+        SpriteAtlas::Sprite::ICON_SWORD,
+        SpriteAtlas::Sprite::ICON_HAT,
+        SpriteAtlas::Sprite::ICON_BOW
+    }};
+    const std::array<SpriteAtlas::Sprite, 3> portraits = {{
+        SpriteAtlas::Sprite::PORTRAIT_KNIGHT,
+        SpriteAtlas::Sprite::PORTRAIT_MAGE,
+        SpriteAtlas::Sprite::PORTRAIT_ARCHER
+    }};
 
     for (size_t i = 0; i < 3; ++i) {
-        // Load class icons
-        if (!classIcons[i].loadFromFile(iconPaths[i])) {
-            Logger::error("Failed to load icon: " + iconPaths[i]);
-            return;
-        }
-        iconSprites[i].setTexture(classIcons[i]);
-        
-        // Scale icons to 48x48 for better visibility
-        float scale = 48.0f / std::max(classIcons[i].getSize().x, classIcons[i].getSize().y);
-        iconSprites[i].setScale(scale, scale);
-
-        // Load character images
-        if (!characterTextures[i].loadFromFile(characterPaths[i])) {
-            Logger::error("Failed to load character image: " + characterPaths[i]);
-            return;
-        }
-        characterSprites[i].setTexture(characterTextures[i]);
-        
-        // Scale character images to fit in the log panel
-        float charScale = 250.0f / std::max(characterTextures[i].getSize().x, characterTextures[i].getSize().y);
-        characterSprites[i].setScale(charScale, charScale);
+        atlas.apply(iconSprites[i], icons[i]);
+        atlas.apply(characterSprites[i], portraits[i]);
     }
 
     // Set up title
-    title.setFont(font);
+    title.setFont(*font);
     title.setString(name + ", Select Your Class");  // Simplified title
     title.setCharacterSize(36);  // Slightly smaller but still visible
     title.setFillColor(sf::Color(255, 215, 0));  // Gold color
@@ -105,13 +88,19 @@ CharacterSelectionState::CharacterSelectionState(const std::string& name)
     logPanel.setOutlineThickness(2);
 
     // Set up log text
-    logText.setFont(font);
+    logText.setFont(*font);
     logText.setCharacterSize(20);
     logText.setFillColor(sf::Color::White);
 
+    // Set up instruction text; centred along the bottom when drawn
+    instructionText.setFont(*font);
+    instructionText.setString("Use UP/DOWN arrows or mouse to select, ENTER to confirm");
+    instructionText.setCharacterSize(24);
+    instructionText.setFillColor(sf::Color(255, 215, 0));
+
     // Initialize option boxes and texts
     for (size_t i = 0; i < 3; ++i) {
-        options[i].setFont(font);
+        options[i].setFont(*font);
         options[i].setString(classNames[i]);  // Only show class name
         options[i].setCharacterSize(24);  // Slightly smaller text
         options[i].setFillColor(sf::Color(220, 220, 220));
@@ -197,11 +186,11 @@ void CharacterSelectionState::handleEvent(const sf::Event& event, sf::RenderWind
                 updatePositions(); // Update log when selection changes
                 break;
             case sf::Keyboard::Return: {
-                Logger::info("Selected character: " + std::to_string(selectedOption));
+                Logger::info("Selected character: ", selectedOption);
                 // Generate boss name
                 std::string bossName = bossFirstNames[rand() % 5] + " " + bossLastNames[rand() % 5];
-                // Create StoryState instead of GamePlayState
-                nextState = std::make_unique<StoryState>(selectedOption, playerName, bossName);
+                // Create StoryState instead of GamePlayState; this screen stays below for the next run
+                pushState(std::make_unique<StoryState>(selectedOption, playerName, bossName));
                 break;
             }
             default:
@@ -260,17 +249,10 @@ void CharacterSelectionState::draw(sf::RenderWindow& window) {
     window.draw(characterSprites[selectedOption]);
 
     // Draw instruction text at bottom
-    sf::Text instruction;
-    instruction.setFont(font);
-    instruction.setString("Use UP/DOWN arrows or mouse to select, ENTER to confirm");
-    instruction.setCharacterSize(24);
-    instruction.setFillColor(sf::Color(255, 215, 0));
-    
-    sf::FloatRect instructionBounds = instruction.getLocalBounds();
-    instruction.setPosition(
+    sf::FloatRect instructionBounds = instructionText.getLocalBounds();
+    instructionText.setPosition(
         (window.getSize().x - instructionBounds.width) / 2,
         window.getSize().y - 60.0f
     );
-    
-    window.draw(instruction);
-} 
\ No newline at end of file
+    window.draw(instructionText);
+}
@@ -0,0 +1,80 @@
+#include "CombatLog.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace {
+const unsigned CHARACTER_SIZE = 16;
+const float LINE_SPACING = 24.0f;
+const float BACKGROUND_HEIGHT = 20.0f;
+const float TEXT_INSET = 10.0f;  // Left edge of the panel to the text
+}
+
+CombatLog::CombatLog() : newest(0), count(0), font(nullptr), width(0.0f) {}
+
+void CombatLog::setLayout(const sf::Font& logFont, const sf::Vector2f& logPosition, float logWidth) {
+    font = &logFont;
+    position = logPosition;
+    width = logWidth;
+    wrapper.setFont(logFont, CHARACTER_SIZE);
+
+    // Rows are laid out at y = 0; draw() moves each one to its slot
+    for (auto& entry : entries) {
+        entry.text.setFont(logFont);
+        entry.text.setCharacterSize(CHARACTER_SIZE);
+        entry.text.setFillColor(sf::Color::White);
+        entry.text.setPosition(position.x + TEXT_INSET, 0);
+        entry.background.setSize(sf::Vector2f(width - 20, BACKGROUND_HEIGHT));
+        entry.background.setPosition(position.x + 5, 0);
+    }
+}
+
+void CombatLog::add(LogCategory category, const std::string& message) {
+    ProfileScope scope(ProfilePhase::COMBAT_LOG);
+    lines.clear();
+    wrapper.wrap(message, width - 3 * TEXT_INSET, lines);  // Ends a few pixels inside the row highlight
+    for (std::string_view line : lines) {
+        if (!line.empty()) {
+            addLine(category, line);
+        }
+    }
+}
+
+void CombatLog::clear() {
+    count = 0;
+}
+
+void CombatLog::addLine(LogCategory category, std::string_view line) {
+    newest = (newest + 1) % MAX_LINES;
+    count = std::min(count + 1, MAX_LINES);
+
+    Entry& entry = entries[newest];
+    entry.text.setString(std::string(line));
+    sf::Color color = categoryColor(category);
+    entry.highlighted = color.a > 0;
+    entry.background.setFillColor(color);
+}
+
+void CombatLog::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!font) return;
+
+    for (size_t row = 0; row < count; ++row) {
+        const Entry& entry = entries[(newest + MAX_LINES - row) % MAX_LINES];
+        sf::RenderStates rowStates = states;
+        rowStates.transform.translate(0, position.y + 10 + row * LINE_SPACING);
+        if (entry.highlighted) {
+            target.draw(entry.background, rowStates);
+        }
+        target.draw(entry.text, rowStates);
+    }
+}
+
+sf::Color CombatLog::categoryColor(LogCategory category) {
+    switch (category) {
+        case LogCategory::PROMPT:        return sf::Color(100, 100, 100, 150);  // Grey for keyboard input options
+        case LogCategory::ENEMY_ACTION:  return sf::Color(150, 50, 50, 150);    // Red for enemy actions and negative events
+        case LogCategory::PLAYER_ACTION: return sf::Color(0, 0, 255, 100);      // Blue for player actions and positive events
+        case LogCategory::DISCOVERY:     return sf::Color(255, 255, 0, 100);    // Yellow for discoveries and battle events
+        case LogCategory::NORMAL:        break;
+    }
+    return sf::Color(0, 0, 0, 0);
+}
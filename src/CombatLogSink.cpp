@@ -0,0 +1,284 @@
+#include "CombatLogSink.h"
+#include "Logger.h"
+#include <sstream>
+
+void CombatLogSink::subscribe(GameEventBus& bus) {
+    bus.subscribe<CharacterCreated, CombatLogSink, &CombatLogSink::onCharacterCreated>(this);
+    bus.subscribe<PlayerMoved, CombatLogSink, &CombatLogSink::onPlayerMoved>(this);
+    bus.subscribe<BattleStart, CombatLogSink, &CombatLogSink::onBattleStart>(this);
+    bus.subscribe<CombatPrompt, CombatLogSink, &CombatLogSink::onCombatPrompt>(this);
+    bus.subscribe<EnemyTurnStarted, CombatLogSink, &CombatLogSink::onEnemyTurnStarted>(this);
+    bus.subscribe<DiceRolled, CombatLogSink, &CombatLogSink::onDiceRolled>(this);
+    bus.subscribe<EscapeAttempted, CombatLogSink, &CombatLogSink::onEscapeAttempted>(this);
+    bus.subscribe<DamageDealt, CombatLogSink, &CombatLogSink::onDamageDealt>(this);
+    bus.subscribe<Dodged, CombatLogSink, &CombatLogSink::onDodged>(this);
+    bus.subscribe<StatusDamage, CombatLogSink, &CombatLogSink::onStatusDamage>(this);
+    bus.subscribe<BattleEnd, CombatLogSink, &CombatLogSink::onBattleEnd>(this);
+    bus.subscribe<LevelUp, CombatLogSink, &CombatLogSink::onLevelUp>(this);
+    bus.subscribe<ItemFound, CombatLogSink, &CombatLogSink::onItemFound>(this);
+    bus.subscribe<ItemPicked, CombatLogSink, &CombatLogSink::onItemPicked>(this);
+    bus.subscribe<ItemLeft, CombatLogSink, &CombatLogSink::onItemLeft>(this);
+    bus.subscribe<ItemUsed, CombatLogSink, &CombatLogSink::onItemUsed>(this);
+    bus.subscribe<InventoryShown, CombatLogSink, &CombatLogSink::onInventoryShown>(this);
+    bus.subscribe<AbilityUsed, CombatLogSink, &CombatLogSink::onAbilityUsed>(this);
+    bus.subscribe<SaveFinished, CombatLogSink, &CombatLogSink::onSaveFinished>(this);
+    bus.subscribe<TurnsRewound, CombatLogSink, &CombatLogSink::onTurnsRewound>(this);
+}
+
+void CombatLogSink::write(LogCategory category, const std::string& message) {
+    Logger::info(message);
+    log.add(category, message);
+}
+
+void CombatLogSink::onCharacterCreated(const CharacterCreated& event) {
+    std::stringstream ss;
+    ss << "Created " << event.character->GetName() << " with " << event.character->GetMaxHealth() << " HP";
+    write(LogCategory::PLAYER_ACTION, ss.str());
+}
+
+void CombatLogSink::onPlayerMoved(const PlayerMoved& event) {
+    std::stringstream ss;
+    ss << "\nMoved to position (" << event.x << ", " << event.y << ")";
+    write(LogCategory::NORMAL, ss.str());
+}
+
+void CombatLogSink::onBattleStart(const BattleStart& event) {
+    log.clear();  // Each battle starts with a fresh log
+
+    std::stringstream ss;
+    ss << "\n=== BATTLE START ===\n";
+    ss << event.player->GetName() << " (HP: " << event.player->GetHealth() << "/" << event.player->GetMaxHealth() << ") VS "
+       << event.enemy->GetName() << " (HP: " << event.enemy->GetHealth() << "/" << event.enemy->GetMaxHealth() << ")";
+    write(LogCategory::DISCOVERY, ss.str());
+}
+
+void CombatLogSink::onCombatPrompt(const CombatPrompt& event) {
+    write(LogCategory::PROMPT, "\nYour turn! Choose your action:");
+    write(LogCategory::PROMPT, "A. Attack");
+    write(LogCategory::PROMPT, "E. Try to escape");
+    write(LogCategory::PROMPT, "I. Use Item/Change Weapon");
+    if (event.abilityDescription) {
+        write(LogCategory::PROMPT, std::string("S. Use Special Ability: ") + event.abilityDescription);
+    }
+}
+
+void CombatLogSink::onEnemyTurnStarted(const EnemyTurnStarted&) {
+    write(LogCategory::ENEMY_ACTION, "\nEnemy's turn!");
+}
+
+void CombatLogSink::onDiceRolled(const DiceRolled& event) {
+    std::stringstream ss;
+    if (event.roll > 0) {
+        ss << "\nDice roll: " << event.roll << " - ";
+    } else {
+        ss << "\n";
+    }
+
+    LogCategory category = LogCategory::PLAYER_ACTION;
+    switch (event.outcome) {
+        case DiceOutcome::HIT:               ss << "Hit!"; break;
+        case DiceOutcome::MARKED_HIT:        ss << "MARKED TARGET HIT!"; break;
+        case DiceOutcome::CRITICAL_HIT:      ss << "CRITICAL HIT!"; break;
+        case DiceOutcome::RAGE_CRITICAL_HIT: ss << "RAGE CRITICAL HIT!"; break;
+        case DiceOutcome::CRITICAL_MISS:
+            ss << "CRITICAL MISS! You are wounded!";
+            category = LogCategory::ENEMY_ACTION;
+            break;
+        case DiceOutcome::MISS:
+            ss << "Miss!";
+            category = LogCategory::NORMAL;
+            break;
+    }
+    write(category, ss.str());
+}
+
+void CombatLogSink::onEscapeAttempted(const EscapeAttempted& event) {
+    std::stringstream ss;
+    if (event.roll > 0) {
+        ss << "\nDice roll: " << event.roll << (event.success ? " - Escape successful!" : " - Escape failed!");
+    } else {
+        ss << (event.success ? "Successfully escaped!" : "Failed to escape!");
+    }
+    write(event.success ? LogCategory::PLAYER_ACTION : LogCategory::ENEMY_ACTION, ss.str());
+}
+
+void CombatLogSink::onDamageDealt(const DamageDealt& event) {
+    std::stringstream ss;
+    if (event.attackerSide == Combatant::ENEMY) {
+        ss << event.attacker->GetName() << " attacks " << event.target->GetName() << " for " << event.amount << " damage!";
+        ss << "\nYour HP: " << event.target->GetHealth() << "/" << event.target->GetMaxHealth();
+        write(LogCategory::ENEMY_ACTION, ss.str());
+        return;
+    }
+
+    if (event.kind == AttackKind::FIREBALL) {
+        ss << "\nFIREBALL! Dealt " << event.amount << " damage (" << (event.maxHealthShare * 100)
+           << "% of max HP) and applied burn effect!";
+    } else {
+        ss << event.attacker->GetName() << " attacks " << event.target->GetName()
+           << " for " << event.amount << " damage";
+        if (event.kind == AttackKind::CRITICAL) {
+            ss << " (CRITICAL HIT!)";
+        }
+        if (event.marksRemaining > 0) {
+            ss << " (MARKED TARGET: " << event.marksRemaining << " marks remaining)";
+        }
+        if (event.weapon) {
+            ss << " with " << event.weapon->GetName();
+        }
+        ss << "!";
+    }
+    ss << "\nEnemy HP: " << event.target->GetHealth() << "/" << event.target->GetMaxHealth();
+    write(LogCategory::PLAYER_ACTION, ss.str());
+}
+
+void CombatLogSink::onDodged(const Dodged& event) {
+    std::stringstream ss;
+    ss << event.defender->GetName() << " dodged the attack!";
+    write(event.defenderSide == Combatant::PLAYER ? LogCategory::PLAYER_ACTION : LogCategory::ENEMY_ACTION, ss.str());
+}
+
+void CombatLogSink::onStatusDamage(const StatusDamage& event) {
+    std::stringstream ss;
+    if (event.effect == StatusEffectType::BURN) {
+        ss << "\nEnemy is burning! (-" << event.amount << " HP)";
+    } else {
+        ss << "\n" << event.target->GetName() << " is bleeding! (-" << event.amount << " HP)";
+    }
+    write(LogCategory::ENEMY_ACTION, ss.str());
+}
+
+void CombatLogSink::onBattleEnd(const BattleEnd& event) {
+    switch (event.outcome) {
+        case BattleOutcome::WON:
+            write(LogCategory::DISCOVERY, "\n=== BATTLE WON! ===");
+            if (event.enemy->GetBoss()) {
+                write(LogCategory::DISCOVERY, "Congratulations! You've defeated the boss!");
+            }
+            break;
+        case BattleOutcome::LOST:
+            write(LogCategory::NORMAL, "\n=== GAME OVER ===");
+            break;
+        case BattleOutcome::ESCAPED:
+            break;  // Already reported by EscapeAttempted
+    }
+}
+
+void CombatLogSink::onLevelUp(const LevelUp& event) {
+    std::stringstream ss;
+    ss << "Level up! " << event.character->GetName() << " reached level " << event.level;
+    write(LogCategory::DISCOVERY, ss.str());
+}
+
+void CombatLogSink::onItemFound(const ItemFound& event) {
+    std::stringstream ss;
+    ss << "You found: " << event.item->GetName() << "\n" << event.item->GetDescription();
+    write(LogCategory::DISCOVERY, ss.str());
+    write(LogCategory::PROMPT, "Press 'P' to pick up or 'L' to leave");
+}
+
+void CombatLogSink::onItemPicked(const ItemPicked& event) {
+    if (event.added) {
+        write(LogCategory::PLAYER_ACTION, "Picked up " + event.item->GetName() + ".");
+    } else {
+        write(LogCategory::PROMPT, "Inventory is full! Press 'L' to leave the item.");
+    }
+}
+
+void CombatLogSink::onItemLeft(const ItemLeft&) {
+    write(LogCategory::NORMAL, "You left the item behind.");
+}
+
+void CombatLogSink::onItemUsed(const ItemUsed& event) {
+    std::stringstream ss;
+    LogCategory category = LogCategory::PLAYER_ACTION;
+    switch (event.result) {
+        case ItemUseResult::HEALED:
+            ss << "Used " << event.item->GetName() << ". Healed for " << event.amount << " HP";
+            ss << "\nHP: " << event.user->GetHealth() << "/" << event.user->GetMaxHealth();
+            break;
+        case ItemUseResult::ALREADY_FULL_HEALTH:
+            ss << "You are already at full health!";
+            category = LogCategory::NORMAL;
+            break;
+        case ItemUseResult::STRENGTHENED:
+            ss << "Used " << event.item->GetName() << ". Attack increased by " << event.amount;
+            ss << "\nNew Attack Power: " << event.user->GetTotalAttack();
+            break;
+        case ItemUseResult::EQUIPPED:
+            ss << "Equipped " << event.item->GetName();
+            ss << "\nNew Attack Power: " << event.user->GetTotalAttack();
+            break;
+        case ItemUseResult::REVEALED:
+            category = LogCategory::DISCOVERY;
+            ss << "Used " << event.item->GetName() << ". ";
+            switch (event.item->GetObjectEffect()) {
+                case ObjectEffect::REVEAL_BOSS:     ss << "The boss location is now revealed!"; break;
+                case ObjectEffect::REVEAL_ITEMS:    ss << "All items are now revealed!"; break;
+                case ObjectEffect::REVEAL_MONSTERS: ss << "All monsters are now revealed!"; break;
+            }
+            break;
+    }
+    write(category, ss.str());
+}
+
+void CombatLogSink::onInventoryShown(const InventoryShown& event) {
+    write(LogCategory::PROMPT, "\nChoose item (1-4) to use or change weapon");
+    write(LogCategory::NORMAL, "Current inventory:");
+
+    const auto& inventory = event.owner->GetInventory();
+    for (size_t i = 0; i < 4; ++i) {
+        std::string displayText = std::to_string(i + 1) + ".";
+        if (i < inventory.size()) {
+            const auto& item = inventory[i];
+            displayText += " " + item->GetName();
+            if (item == event.owner->GetEquippedWeapon()) {
+                displayText += " (E)";
+            }
+            displayText += " - " + item->GetDescription();
+        } else {
+            displayText += " Empty";
+        }
+        write(LogCategory::PROMPT, displayText);
+    }
+}
+
+void CombatLogSink::onAbilityUsed(const AbilityUsed& event) {
+    switch (event.ability) {
+        case Ability::RAGE:
+            write(LogCategory::PLAYER_ACTION, "\nRAGE ACTIVATED! Your next attack will be a critical hit!");
+            break;
+        case Ability::HUNTERS_MARK:
+            write(LogCategory::PLAYER_ACTION, "\nHUNTER'S MARK ACTIVATED! Your next three attacks cannot miss!");
+            break;
+        case Ability::FIREBALL:
+            break;  // The fireball hit is reported by DamageDealt
+    }
+}
+
+void CombatLogSink::onSaveFinished(const SaveFinished& event) {
+    const bool saving = event.operation == SaveOperation::SAVE;
+    std::stringstream ss;
+    switch (event.result) {
+        case SaveResult::DONE:
+            ss << (saving ? "\nGame saved" : "\nSaved game loaded") << " (" << event.milliseconds << " ms)";
+            write(LogCategory::DISCOVERY, ss.str());
+            break;
+        case SaveResult::REFUSED:
+            write(LogCategory::NORMAL, "\nThe game can only be saved while exploring.");
+            break;
+        case SaveResult::FAILED:
+            write(LogCategory::ENEMY_ACTION, saving ? "\nSaving failed." : "\nNo saved game could be loaded.");
+            break;
+    }
+}
+
+void CombatLogSink::onTurnsRewound(const TurnsRewound& event) {
+    if (event.turns == 0) {
+        write(LogCategory::NORMAL, "\nThere is no turn to undo.");
+        return;
+    }
+    std::stringstream ss;
+    ss << "\nUndid " << event.turns << (event.turns == 1 ? " turn" : " turns") << " (" << event.milliseconds << " ms)";
+    write(LogCategory::PLAYER_ACTION, ss.str());
+}
@@ -0,0 +1,36 @@
+#include "FixedTimestep.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(int rate) : step(1.0f / rate), accumulator(0) {}
+
+int FixedTimestep::advance(float elapsedSeconds) {
+    accumulator += elapsedSeconds;
+    int steps = static_cast<int>(accumulator / step);
+    if (steps > MAX_CATCH_UP_STEPS) {
+        Logger::debug("Dropped ", steps - MAX_CATCH_UP_STEPS, " simulation steps after a stall");
+        steps = MAX_CATCH_UP_STEPS;
+        accumulator = std::fmod(accumulator, step) + steps * step;
+    }
+    accumulator -= steps * step;
+    return steps;
+}
+
+int FixedTimestep::configuredRate() {
+    // Read once; the main loop and the simulation thread must agree
+    static const int rate = [] {
+        const char* value = std::getenv("FIGHTGPT_TICK_RATE");
+        if (!value) return DEFAULT_RATE;
+
+        const int parsed = std::atoi(value);
+        if (parsed < MIN_RATE || parsed > MAX_RATE) {
+            Logger::error("Ignoring FIGHTGPT_TICK_RATE=", value, ", expected steps per second from ", MIN_RATE,
+                          " to ", MAX_RATE);
+            return DEFAULT_RATE;
+        }
+        Logger::info("Simulation rate: ", parsed, " steps per second");
+        return parsed;
+    }();
+    return rate;
+}
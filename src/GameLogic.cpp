@@ -1,37 +1,37 @@
 #include "GameLogic.h"
 #include "Logger.h"
+#include "Profiler.h"
 #include <iostream>
 #include <sstream>
 #include <random>
 #include <queue>
+#include <algorithm>
+#include <atomic>
 
-int Character::TakeDamage(int damage) {
+int Character::TakeDamage(int damage, Pcg32& rng) {
     // If this is healing (negative damage)
     if (damage < 0) {
         int healAmount = -damage; // Convert to positive
         int oldHealth = health;
-        health = std::min(maxHealth, health + healAmount); // Can't heal beyond max health
+        health = std::min(maxHealth.Get(), health + healAmount); // Can't heal beyond max health
         return health - oldHealth; // Return actual amount healed
     }
 
     // Normal damage handling
-    if (rand() % 100 < avoidance) {
-        Logger::info(name + " avoided the attack!");
+    if (std::uniform_int_distribution<int>(0, 99)(rng) < avoidance) {
+        Logger::debug(name, " avoided the attack!");
         return 0;
     }
 
     // New damage calculation formula with some randomness
     float defenseReduction = static_cast<float>(defense) / (defense + 50);  // Defense has diminishing returns
-    float damageMultiplier = (rand() % 30 + 85) / 100.0f;  // Random damage between 85% and 115%
+    float damageMultiplier = std::uniform_int_distribution<int>(85, 114)(rng) / 100.0f;  // Random damage between 85% and 115%
     int damageTaken = static_cast<int>(damage * (1.0f - defenseReduction) * damageMultiplier);
     damageTaken = std::max(1, damageTaken);  // Always deal at least 1 damage
     
-    health -= damageTaken;
-    health = std::max(0, health);  // Don't go below 0
+    health = std::max(0, health - damageTaken);  // Don't go below 0
     
-    std::stringstream ss;
-    ss << name << " took " << damageTaken << " damage. Health: " << health;
-    Logger::info(ss.str());
+    Logger::debug(name, " took ", damageTaken, " damage. Health: ", health.Get());
     
     return damageTaken;
 }
@@ -62,9 +62,10 @@ void Character::PrintStats() const {
 
 bool Battle::Fight(Character& character1, Character& character2) {
     Logger::info("\n=== BATTLE START ===");
-    Logger::info(character1.GetName() + " (HP: " + std::to_string(character1.GetHealth()) + ") VS " + 
-                character2.GetName() + " (HP: " + std::to_string(character2.GetHealth()) + ")");
+    Logger::info(character1.GetName(), " (HP: ", character1.GetHealth(), ") VS ",
+                 character2.GetName(), " (HP: ", character2.GetHealth(), ")");
     
+    Pcg32 rng = Pcg32::FromRandomDevice();
     bool playerTurn = character1.GetSpeed() > character2.GetSpeed();
     bool battleEnded = false;
     bool escaped = false;
@@ -78,11 +79,10 @@ bool Battle::Fight(Character& character1, Character& character2) {
             // Wait for input (this will be handled by the game state)
             // For now, always attack
             int damage = character1.GetAttack();
-            character2.TakeDamage(damage);
+            character2.TakeDamage(damage, rng);
             
-            Logger::info("\n" + character1.GetName() + " attacks " + character2.GetName() + "!");
-            Logger::info("Enemy HP: " + std::to_string(character2.GetHealth()) + "/" + 
-                        std::to_string(character2.GetMaxHealth()));
+            Logger::info("\n", character1.GetName(), " attacks ", character2.GetName(), "!");
+            Logger::info("Enemy HP: ", character2.GetHealth(), "/", character2.GetMaxHealth());
             
             if (character2.IsDefeated()) {
                 battleEnded = true;
@@ -92,11 +92,10 @@ bool Battle::Fight(Character& character1, Character& character2) {
             // Enemy turn
             Logger::info("\nEnemy's turn!");
             int damage = character2.GetAttack();
-            character1.TakeDamage(damage);
+            character1.TakeDamage(damage, rng);
             
-            Logger::info(character2.GetName() + " attacks " + character1.GetName() + "!");
-            Logger::info("Your HP: " + std::to_string(character1.GetHealth()) + "/" + 
-                        std::to_string(character1.GetMaxHealth()));
+            Logger::info(character2.GetName(), " attacks ", character1.GetName(), "!");
+            Logger::info("Your HP: ", character1.GetHealth(), "/", character1.GetMaxHealth());
             
             if (character1.IsDefeated()) {
                 battleEnded = true;
@@ -107,7 +106,7 @@ bool Battle::Fight(Character& character1, Character& character2) {
     }
 
     bool result = !character1.IsDefeated();
-    Logger::info("\n=== BATTLE " + std::string(result ? "WON!" : "LOST!") + " ===\n");
+    Logger::info("\n=== BATTLE ", result ? "WON!" : "LOST!", " ===\n");
     return result;
 }
 
@@ -119,13 +118,54 @@ void Battle::Reward(Character& winner, Character& loser) {
     winner.AddExperience(exp);  // Use AddExperience instead of direct LevelUp call
 }
 
-Map::Map(int width, int height)
-    : width(width), height(height), 
+const std::vector<Item>& GetItemCatalog() {
+    static const std::vector<Item> catalog = {
+        // Potions
+        Item("Apple", "Restores 30 HP", ItemType::POTION, 30),
+        Item("Health Potion", "Restores 50 HP", ItemType::POTION, 50),
+        Item("Strength Potion", "Temporarily increases attack by 10", ItemType::POTION, 10),
+
+        // Weapons
+        Item("Throwing Knife", "Increases attack by 15", ItemType::WEAPON, 15),
+        Item("Void staff", "Increases attack by 20", ItemType::WEAPON, 20),
+        Item("Legendary Sword", "Increases attack by 30", ItemType::WEAPON, 30),
+
+        // Objects
+        Item("Boss Compass", "Reveals the boss location", ItemType::OBJECT, 0, ObjectEffect::REVEAL_BOSS),
+        Item("Monster Radar", "Reveals all monsters", ItemType::OBJECT, 0, ObjectEffect::REVEAL_MONSTERS),
+        Item("Treasure Map", "Reveals all items", ItemType::OBJECT, 0, ObjectEffect::REVEAL_ITEMS)
+    };
+    return catalog;
+}
+
+int FindCatalogItem(const Item& item) {
+    const std::vector<Item>& catalog = GetItemCatalog();
+    for (size_t i = 0; i < catalog.size(); ++i) {
+        if (catalog[i].GetName() == item.GetName()) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+namespace {
+// Shared by every map, so a new or loaded map never reuses the revision of the one it replaces
+std::atomic<unsigned> lastWallRevision{0};
+}
+
+Map::Map(int width, int height, const Pcg32& rng)
+    : width(width), height(height),
       grid(width, std::vector<Character*>(height)),
       item_grid(width, std::vector<std::shared_ptr<Item>>(height)),
       walls(width, std::vector<bool>(height, false)),
-      rng(std::random_device()()) {
-    PopulateWalls(30); // Add 30 wall segments
+      wallRevision(++lastWallRevision),
+      rng(rng) {}
+
+Map::Map(int width, int height)
+    : Map(width, height, Pcg32::RandomSeed()) {}
+
+Map::Map(int width, int height, uint64_t seed)
+    : Map(width, height, Pcg32(seed)) {
+    TraceScope scope("Generate map");
+    PopulateWalls(std::max(1, 30 * width * height / (15 * 15))); // 30 wall segments per 15x15 area
     PopulateMonsters(5);
     PopulateBoss();
     PopulateItems(8);
@@ -142,17 +182,17 @@ void Map::PlaceCharacter(Character& character) {
         y = distY(rng);
     }
 
-    grid[x][y] = &character;
+    SetOccupant(x, y, &character);
     character.SetX(x);
     character.SetY(y);
+    changedCells.emplace_back(x, y);
     
-    Logger::info("Placed " + character.GetName() + " at position (" + 
-                std::to_string(x) + ", " + std::to_string(y) + ")");
+    Logger::debug("Placed ", character.GetName(), " at position (", x, ", ", y, ")");
 }
 
 void Map::MoveCharacter(Character& character, int dx, int dy) {
     if ((dx != 0 && dy != 0) || (dx == 0 && dy == 0)) {
-        Logger::info("Invalid move!");
+        Logger::debug("Invalid move!");
         return;
     }
 
@@ -162,22 +202,23 @@ void Map::MoveCharacter(Character& character, int dx, int dy) {
     int newY = y + dy;
 
     if (newX < 0 || newX >= width || newY < 0 || newY >= height) {
-        Logger::info("Move out of bounds!");
+        Logger::debug("Move out of bounds!");
         return;
     }
 
     if (grid[newX][newY] != nullptr || walls[newX][newY]) {
-        Logger::info("Position occupied or blocked by wall!");
+        Logger::debug("Position occupied or blocked by wall!");
         return;
     }
 
-    grid[newX][newY] = &character;
-    grid[x][y] = nullptr;
+    SetOccupant(newX, newY, &character);
+    SetOccupant(x, y, nullptr);
     character.SetX(newX);
     character.SetY(newY);
+    changedCells.emplace_back(x, y);
+    changedCells.emplace_back(newX, newY);
     
-    Logger::info(character.GetName() + " moved to position (" + 
-                std::to_string(newX) + ", " + std::to_string(newY) + ")");
+    Logger::debug(character.GetName(), " moved to position (", newX, ", ", newY, ")");
 }
 
 void Map::PopulateMonsters(int n) {
@@ -192,7 +233,8 @@ void Map::PopulateMonsters(int n) {
         int speed = static_cast<int>(15 * difficultyMult);
         int avoidance = static_cast<int>(10 * difficultyMult);
         
-        Character* monster = new Character(name, health, attack, defence, speed, avoidance);
+        enemies.push_back(std::make_unique<Character>(name, health, attack, defence, speed, avoidance));
+        Character* monster = enemies.back().get();
         monster->SetLevel(i + 1);
         PlaceCharacter(*monster);
     }
@@ -207,7 +249,8 @@ void Map::PopulateBoss() {
     int speed = 20;
     int avoidance = 15;
     
-    Character* boss = new Character(name, health, attack, defence, speed, avoidance);
+    enemies.push_back(std::make_unique<Character>(name, health, attack, defence, speed, avoidance));
+    Character* boss = enemies.back().get();
     boss->SetLevel(5);
     boss->SetBoss();
     PlaceCharacter(*boss);
@@ -221,22 +264,20 @@ std::string Map::GenerateRandomName() {
         "Morgath the Defiler",
         "Vorgath the Annihilator"
     };
-    return names[rand() % 5];
+    return names[std::uniform_int_distribution<int>(0, 4)(rng)];
 }
 
 int Map::GenerateRandomStat(int min, int max) {
-    return min + (rand() % (max - min + 1));
+    return std::uniform_int_distribution<int>(min, max)(rng);
 }
 
 void Map::RemoveEnemy(Character& enemy, int /*dx*/, int /*dy*/) {
-    // Find and remove the enemy from the grid
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (grid[y][x] == &enemy) {
-                grid[y][x] = nullptr;
-                return;
-            }
-        }
+    // Remove the enemy from the grid cell it occupies
+    int x = enemy.GetX();
+    int y = enemy.GetY();
+    if (x >= 0 && x < width && y >= 0 && y < height && grid[x][y] == &enemy) {
+        SetOccupant(x, y, nullptr);
+        changedCells.emplace_back(x, y);
     }
 }
 
@@ -250,7 +291,7 @@ Character* Map::CheckNewPosition(Character& mainCharacter, int dx, int dy) {
     }
     
     if (grid[newX][newY] != nullptr) {
-        Logger::info("Found enemy: " + grid[newX][newY]->GetName());
+        Logger::debug("Found enemy: ", grid[newX][newY]->GetName());
         return grid[newX][newY];
     }
     return nullptr;
@@ -265,10 +306,18 @@ std::shared_ptr<Item> Map::GetItemAtPosition(int x, int y) const {
 
 void Map::RemoveItemAtPosition(int x, int y) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
-        item_grid[x][y] = nullptr;
+        SetItem(x, y, nullptr);
+        changedCells.emplace_back(x, y);
     }
 }
 
+void Map::SetItem(int x, int y, std::shared_ptr<Item> item) {
+    const int64_t oldId = item_grid[x][y] ? FindCatalogItem(*item_grid[x][y]) + 1 : 0;
+    const int64_t newId = item ? FindCatalogItem(*item) + 1 : 0;
+    stateHash.Change(CellFeature(x, y, HASH_ITEM), oldId, newId);
+    item_grid[x][y] = std::move(item);
+}
+
 void Map::PlaceItem(std::shared_ptr<Item> item) {
     std::uniform_int_distribution<int> distX(0, width - 1);
     std::uniform_int_distribution<int> distY(0, height - 1);
@@ -280,36 +329,19 @@ void Map::PlaceItem(std::shared_ptr<Item> item) {
         y = distY(rng);
     }
 
-    item_grid[x][y] = item;
-    Logger::info("Placed item " + item->GetName() + " at position (" + 
-                std::to_string(x) + ", " + std::to_string(y) + ")");
+    SetItem(x, y, item);
+    changedCells.emplace_back(x, y);
+    Logger::debug("Placed item ", item->GetName(), " at position (", x, ", ", y, ")");
 }
 
 std::vector<std::shared_ptr<Item>> Map::CreateRandomItems(int count) {
     std::vector<std::shared_ptr<Item>> items;
-    
-    // Define possible items
-    std::vector<std::shared_ptr<Item>> possibleItems = {
-        // Potions
-        std::make_shared<Item>("Apple", "Restores 30 HP", ItemType::POTION, 30),
-        std::make_shared<Item>("Health Potion", "Restores 50 HP", ItemType::POTION, 50),
-        std::make_shared<Item>("Strength Potion", "Temporarily increases attack by 10", ItemType::POTION, 10),
-        
-        // Weapons
-        std::make_shared<Item>("Throwing Knife", "Increases attack by 15", ItemType::WEAPON, 15),
-        std::make_shared<Item>("Void staff", "Increases attack by 20", ItemType::WEAPON, 20),
-        std::make_shared<Item>("Legendary Sword", "Increases attack by 30", ItemType::WEAPON, 30),
-        
-        // Objects
-        std::make_shared<Item>("Boss Compass", "Reveals the boss location", ItemType::OBJECT, 0, ObjectEffect::REVEAL_BOSS),
-        std::make_shared<Item>("Monster Radar", "Reveals all monsters", ItemType::OBJECT, 0, ObjectEffect::REVEAL_MONSTERS),
-        std::make_shared<Item>("Treasure Map", "Reveals all items", ItemType::OBJECT, 0, ObjectEffect::REVEAL_ITEMS)
-    };
+    const std::vector<Item>& possibleItems = GetItemCatalog();
 
     // Randomly select items
     std::uniform_int_distribution<int> dist(0, possibleItems.size() - 1);
     for (int i = 0; i < count; ++i) {
-        items.push_back(possibleItems[dist(rng)]);
+        items.push_back(std::make_shared<Item>(possibleItems[dist(rng)]));
     }
 
     return items;
@@ -343,8 +375,8 @@ void Map::PopulateWalls(int wallCount) {
             // Check bounds and don't place walls at edges
             if (x >= 1 && x < width - 1 && y >= 1 && y < height - 1) {
                 // Add some randomness to wall placement
-                if (rand() % 100 < 80) {  // 80% chance to place each wall segment
-                    walls[x][y] = true;
+                if (std::uniform_int_distribution<int>(0, 99)(rng) < 80) {  // 80% chance to place each wall segment
+                    SetWall(x, y, true);
                 }
             }
         }
@@ -361,7 +393,8 @@ void Map::PopulateWalls(int wallCount) {
         q.pop();
 
         // Check all 4 directions
-        for (const auto& [dx, dy] : std::vector<std::pair<int, int>>{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}) {
+        static const std::pair<int, int> directions[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (const auto& [dx, dy] : directions) {
             int newX = x + dx;
             int newY = y + dy;
 
@@ -376,7 +409,7 @@ void Map::PopulateWalls(int wallCount) {
     for (int x = 0; x < width; ++x) {
         for (int y = 0; y < height; ++y) {
             if (!visited[x][y] && walls[x][y]) {
-                walls[x][y] = false;
+                SetWall(x, y, false);
             }
         }
     }
@@ -395,47 +428,63 @@ void Map::PopulateWalls(int wallCount) {
                     int newX = x + dx;
                     int newY = y + dy;
                     if (newX >= 1 && newX < width - 1 && newY >= 1 && newY < height - 1) {
-                        if (rand() % 100 < 60) {  // 60% chance for each adjacent wall
-                            walls[newX][newY] = true;
+                        if (std::uniform_int_distribution<int>(0, 99)(rng) < 60) {  // 60% chance for each adjacent wall
+                            SetWall(newX, newY, true);
                         }
                     }
                 }
             }
         }
     }
+    wallRevision = ++lastWallRevision;
 }
 
 void Map::MoveMonsters(Character& player) {
-    // Move each monster one step in a random direction if not blocked
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            Character* monster = grid[x][y];
-            if (monster && monster != &player && !monster->GetBoss()) {
-                // Generate random direction (0: up, 1: right, 2: down, 3: left)
-                std::uniform_int_distribution<int> distDir(0, 3);
-                int direction = distDir(rng);
-                
-                int dx = 0, dy = 0;
-                switch (direction) {
-                    case 0: dy = -1; break; // up
-                    case 1: dx = 1; break;  // right
-                    case 2: dy = 1; break;  // down
-                    case 3: dx = -1; break; // left
-                }
+    ProfileScope scope(ProfilePhase::MOVE_MONSTERS);
+
+    // Move each monster one step in a random direction if not blocked. Walking
+    // the enemy list rather than the grid keeps this independent of map size.
+    for (const auto& enemy : enemies) {
+        Character* monster = enemy.get();
+        int x = monster->GetX();
+        int y = monster->GetY();
+        if (monster != &player && !monster->GetBoss() && grid[x][y] == monster) {
+            // Generate random direction (0: up, 1: right, 2: down, 3: left)
+            std::uniform_int_distribution<int> distDir(0, 3);
+            int direction = distDir(rng);
+            
+            int dx = 0, dy = 0;
+            switch (direction) {
+                case 0: dy = -1; break; // up
+                case 1: dx = 1; break;  // right
+                case 2: dy = 1; break;  // down
+                case 3: dx = -1; break; // left
+            }
 
-                // Try to move in the random direction
-                int newX = x + dx;
-                int newY = y + dy;
-
-                // Check if move is valid and not blocked
-                if (newX >= 0 && newX < width && newY >= 0 && newY < height &&
-                    grid[newX][newY] == nullptr && !walls[newX][newY]) {
-                    grid[newX][newY] = monster;
-                    grid[x][y] = nullptr;
-                    monster->SetX(newX);
-                    monster->SetY(newY);
-                }
+            // Try to move in the random direction
+            int newX = x + dx;
+            int newY = y + dy;
+
+            // Check if move is valid and not blocked
+            if (newX >= 0 && newX < width && newY >= 0 && newY < height &&
+                grid[newX][newY] == nullptr && !walls[newX][newY]) {
+                SetOccupant(newX, newY, monster);
+                SetOccupant(x, y, nullptr);
+                monster->SetX(newX);
+                monster->SetY(newY);
+                changedCells.emplace_back(x, y);
+                changedCells.emplace_back(newX, newY);
             }
         }
     }
-} 
\ No newline at end of file
+}
+
+uint64_t Map::GetStateHash(const Character& player) const {
+    uint64_t hash = stateHash.Get() ^ StateHash::Combine(player.GetStateHash(), 0);
+    // Enemies keep their spawn order for the whole run, defeated ones included,
+    // and saves keep it too, so the slot means the same enemy after a load
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        hash ^= StateHash::Combine(enemies[i]->GetStateHash(), i + 1);
+    }
+    return hash;
+}
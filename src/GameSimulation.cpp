@@ -0,0 +1,884 @@
+#include "GameSimulation.h"
+#include "FixedTimestep.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+
+GameSimulation::GameSimulation(int selectedCharacter, const std::string& playerName, sf::Vector2i mapSize)
+    : player(nullptr),
+      gameMap(nullptr),
+      currentEnemy(nullptr),
+      combatState(CombatState::NOT_IN_COMBAT),
+      selectedCharacter(selectedCharacter),
+      playerName(playerName),
+      gameOver(false),
+      returnToMenu(false),
+      currentDiceValue(1),
+      diceRng(),
+      diceAnimationTime(0),
+      isRollingDice(false),
+      showingItemPrompt(false),
+      currentItem(nullptr),
+      bossRevealed(false),
+      itemsRevealed(false),
+      monstersRevealed(false),
+      statsChanged(true),
+      inputsConsumed(0),
+      publishedLogSequence(0),
+      turnPending(false),
+      turnSteps(0) {
+
+    // The seeds are kept so that FIGHTGPT_REPLAY can generate the same run again
+    ReplayLog::Start start;
+    start.characterClass = selectedCharacter;
+    start.mapWidth = mapSize.x;
+    start.mapHeight = mapSize.y;
+    start.mapSeed = Pcg32::RandomSeed();
+    start.diceSeed = Pcg32::RandomSeed();
+    if (const char* replayPath = ReplayLog::configuredPath()) {
+        replay.open(replayPath, start);  // A replay brings its own start
+    }
+    this->selectedCharacter = start.characterClass;
+    gameMap = std::make_unique<Map>(start.mapWidth, start.mapHeight, start.mapSeed);
+    diceRng = Pcg32(start.diceSeed);
+
+    // Route gameplay events to the combat log
+    combatLogSink.subscribe(events);
+
+    initializeStats();
+
+    // The render thread gets a complete first state before the thread starts
+    if (player) {
+        rewind.Reset(*player, *gameMap, getRun());
+        tick(0);
+        publish();
+    }
+}
+
+GameSimulation::~GameSimulation() {
+    stop();
+}
+
+void GameSimulation::start() {
+    if (thread.joinable() || !player) return;
+    stopRequested.store(false, std::memory_order_relaxed);
+    thread = std::thread(&GameSimulation::run, this);
+}
+
+void GameSimulation::stop() {
+    if (!thread.joinable()) return;
+    stopRequested.store(true, std::memory_order_relaxed);
+    thread.join();
+}
+
+void GameSimulation::run() {
+    Logger::info("Simulation thread started");
+    Tracer::Instance().nameThread("Simulation");
+    FixedTimestep timestep;
+    sf::Clock clock;
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (paused.load(std::memory_order_relaxed)) {
+            // No input arrives while paused; the paused time is never simulated
+            sf::sleep(sf::seconds(timestep.getStep()));
+            clock.restart();
+            continue;
+        }
+
+        // Everything pressed since the last step; a combat turn may pause in
+        // here, which delays the next snapshot but never a frame. The pause
+        // itself is not simulated beyond the catch-up cap.
+        bool changed = false;
+        sf::Event event;
+        while (inputs.pop(event)) {
+            // During a replay the player's keys are answered but not played
+            if (replay.getMode() != ReplayLog::Mode::REPLAYING) {
+                if (event.type == sf::Event::KeyPressed) replay.recordKey(turnSteps, event.key.code);
+                handleEvent(event);
+            }
+            ++inputsConsumed;
+            changed = true;
+        }
+        changed |= playReplayKeys();
+
+        // A replay stops at every step where a recorded key or turn end is due,
+        // so each lands on the same step as in the recording
+        int steps = timestep.advance(clock.restart().asSeconds());
+        steps = static_cast<int>(std::min<uint32_t>(steps, replay.getNextStep() - turnSteps));
+        for (int step = 0; step < steps; ++step) {
+            changed |= tick(timestep.getStep());
+            ++turnSteps;
+        }
+
+        // A turn is recorded once its action has played out, dice roll included
+        const bool turnEnds = replay.getMode() == ReplayLog::Mode::REPLAYING ? replay.isTurnEndAt(turnSteps)
+                                                                             : turnPending && !isRollingDice;
+        if (turnEnds) {
+            endTurn();
+        }
+        if (changed) {
+            publish();
+        }
+        sf::sleep(sf::seconds(timestep.getTimeToNextStep()));
+    }
+    Logger::info("Simulation thread stopped");
+}
+
+bool GameSimulation::tick(float deltaTime) {
+    ProfileScope scope(ProfilePhase::SIMULATION);
+
+    // Update timed effects (strength buff)
+    StatusEffectScheduler::Instance().AdvanceTime(deltaTime);
+
+    // Update dice animation
+    updateDiceRoll(deltaTime);
+
+    // Check for items at player's position
+    if (!showingItemPrompt && combatState == CombatState::NOT_IN_COMBAT) {
+        checkForItems();
+    }
+
+    // Cells changed by this turn's moves, pickups and defeats
+    MinimapVisibility visibility;
+    visibility.playerX = player->GetX();
+    visibility.playerY = player->GetY();
+    visibility.sightRadius = SIGHT_RADIUS;
+    visibility.bossRevealed = bossRevealed;
+    visibility.itemsRevealed = itemsRevealed;
+    visibility.monstersRevealed = monstersRevealed;
+    minimapFeed.update(*gameMap, visibility);
+    rewind.NoteChangedCells(gameMap->GetChangedCells());
+    const bool mapChanged = !gameMap->GetChangedCells().empty();
+    gameMap->ClearChangedCells();
+
+    // The dice and timed effects change the picture without any input
+    return isAnimating() || mapChanged || statsChanged || combatLog.getNextSequence() != publishedLogSequence;
+}
+
+bool GameSimulation::isAnimating() const {
+    // The dice roll animates, and timed effects count down in the stats panel
+    return isRollingDice ||
+           StatusEffectScheduler::Instance().GetWheel(EffectClock::SECONDS).GetScheduledCount() > 0;
+}
+
+void GameSimulation::onStatsChanged(StatMask changed) {
+    if (changed) statsChanged = true;
+}
+
+void GameSimulation::publish() {
+    RenderSnapshot& snapshot = snapshots.back();
+    snapshot.inputsConsumed = inputsConsumed;
+    snapshot.animating = isAnimating();
+
+    RenderSnapshot::PlayerStats& stats = snapshot.player;
+    stats.name = player->GetName();
+    stats.x = player->GetX();
+    stats.y = player->GetY();
+    stats.level = player->GetLevel();
+    stats.health = player->GetHealth();
+    stats.maxHealth = player->GetMaxHealth();
+    stats.attack = player->GetAttack();
+    stats.totalAttack = player->GetTotalAttack();
+    stats.hasStrengthBuff = player->HasStrengthBuff();
+    stats.buffSeconds = stats.hasStrengthBuff ? static_cast<int>(player->GetStrengthBuffDuration()) : 0;
+    stats.wounded = player->IsWounded();
+    stats.defense = player->GetDefense();
+    stats.speed = player->GetSpeed();
+    stats.avoidance = player->GetAvoidance();
+    stats.experience = player->GetExperience();
+
+    const auto& inventory = player->GetInventory();
+    snapshot.equippedSlot = -1;
+    for (size_t i = 0; i < RenderSnapshot::INVENTORY_SLOTS; ++i) {
+        if (i < inventory.size()) {
+            snapshot.inventory[i] = inventory[i]->GetName();
+            if (inventory[i] == player->GetEquippedWeapon()) snapshot.equippedSlot = static_cast<int>(i);
+        } else {
+            snapshot.inventory[i].clear();
+        }
+    }
+
+    snapshot.inCombat = currentEnemy && combatState != CombatState::NOT_IN_COMBAT;
+    if (snapshot.inCombat) {
+        RenderSnapshot::EnemyStats& enemy = snapshot.enemy;
+        enemy.name = currentEnemy->GetName();
+        enemy.boss = currentEnemy->GetBoss();
+        enemy.health = currentEnemy->GetHealth();
+        enemy.maxHealth = currentEnemy->GetMaxHealth();
+        enemy.attack = currentEnemy->GetAttack();
+        enemy.defense = currentEnemy->GetDefense();
+        enemy.speed = currentEnemy->GetSpeed();
+    }
+
+    snapshot.characterClass = selectedCharacter;
+    snapshot.diceValue = currentDiceValue;
+    snapshot.gameOver = gameOver;
+    snapshot.victory = player->GetHealth() > 0;
+    snapshot.returnToMenu = returnToMenu;
+
+    snapshot.mapWidth = gameMap->GetWidth();
+    snapshot.mapHeight = gameMap->GetHeight();
+    snapshot.wallRevision = gameMap->GetWallRevision();
+    snapshot.bossRevealed = bossRevealed;
+    snapshot.itemsRevealed = itemsRevealed;
+    snapshot.monstersRevealed = monstersRevealed;
+    fillMapWindow(snapshot);
+
+    snapshot.log = combatLog;
+
+    snapshots.publish();
+    statsChanged = false;
+    publishedLogSequence = combatLog.getNextSequence();
+}
+
+void GameSimulation::fillMapWindow(RenderSnapshot& snapshot) const {
+    const int left = std::max(0, player->GetX() - SNAPSHOT_RADIUS);
+    const int top = std::max(0, player->GetY() - SNAPSHOT_RADIUS);
+    const int right = std::min(gameMap->GetWidth(), player->GetX() + SNAPSHOT_RADIUS + 1);
+    const int bottom = std::min(gameMap->GetHeight(), player->GetY() + SNAPSHOT_RADIUS + 1);
+    snapshot.windowLeft = left;
+    snapshot.windowTop = top;
+    snapshot.windowWidth = right - left;
+    snapshot.windowHeight = bottom - top;
+    snapshot.cells.assign(static_cast<size_t>(snapshot.windowWidth) * snapshot.windowHeight, 0);
+
+    // Markers are overwritten in place so their names keep their storage
+    size_t enemyCount = 0;
+    for (int y = top; y < bottom; ++y) {
+        for (int x = left; x < right; ++x) {
+            uint8_t& flags = snapshot.cells[static_cast<size_t>(y - top) * snapshot.windowWidth + (x - left)];
+            if (gameMap->HasWall(x, y)) flags |= RenderSnapshot::WALL;
+            if (gameMap->GetItemAtPosition(x, y)) flags |= RenderSnapshot::ITEM;
+
+            const Character* enemy = gameMap->GetCharacterAt(x, y);
+            if (!enemy || enemy == player.get()) continue;
+            if (enemyCount == snapshot.enemies.size()) snapshot.enemies.emplace_back();
+            RenderSnapshot::EnemyMarker& marker = snapshot.enemies[enemyCount++];
+            marker.x = x;
+            marker.y = y;
+            marker.boss = enemy->GetBoss();
+            marker.healthFraction = static_cast<float>(enemy->GetHealth()) / enemy->GetMaxHealth();
+            marker.name = enemy->GetName();
+        }
+    }
+    snapshot.enemies.resize(enemyCount);
+}
+
+void GameSimulation::initializeStats() {
+    std::string className;
+    int health, attack, defense, speed, avoidance;
+
+    switch (selectedCharacter) {
+        case 0: // Knight
+            className = "Knight";
+            health = 120;    // Reduced from 150
+            attack = 25;     // Reduced from 30
+            defense = 25;    // Increased from 20
+            speed = 12;      // Reduced from 15
+            avoidance = 8;   // Reduced from 10
+            break;
+        case 1: // Mage
+            className = "Mage";
+            health = 80;     // Reduced from 100
+            attack = 35;     // Reduced from 40
+            defense = 8;     // Reduced from 10
+            speed = 15;      // Reduced from 20
+            avoidance = 12;  // Reduced from 15
+            break;
+        case 2: // Archer
+            className = "Archer";
+            health = 90;     // Reduced from 120
+            attack = 28;     // Reduced from 35
+            defense = 12;    // Reduced from 15
+            speed = 20;      // Reduced from 25
+            avoidance = 18;  // Reduced from 20
+            break;
+        default:
+            Logger::error("Invalid character selection!");
+            return;
+    }
+
+    player = std::make_unique<Character>(playerName + " the " + className, health, attack, defense, speed, avoidance);
+    player->GetStatNotifier().Subscribe<GameSimulation, &GameSimulation::onStatsChanged>(this);
+    gameMap->PlaceCharacter(*player);
+    events.publish(CharacterCreated{player.get()});
+}
+
+void GameSimulation::showCombatOptions(bool offerAbility) {
+    events.publish(CombatPrompt{offerAbility && !player->HasUsedAbility() ? getAbilityDescription() : nullptr});
+}
+
+SaveGame::Run GameSimulation::getRun() const {
+    SaveGame::Run run;
+    run.characterClass = selectedCharacter;
+    run.bossRevealed = bossRevealed;
+    run.itemsRevealed = itemsRevealed;
+    run.monstersRevealed = monstersRevealed;
+    run.diceRng = diceRng;
+    return run;
+}
+
+void GameSimulation::setRun(const SaveGame::Run& run) {
+    selectedCharacter = run.characterClass;
+    bossRevealed = run.bossRevealed;
+    itemsRevealed = run.itemsRevealed;
+    monstersRevealed = run.monstersRevealed;
+    diceRng = run.diceRng;
+}
+
+void GameSimulation::resetEncounter() {
+    currentEnemy = nullptr;
+    combatState = CombatState::NOT_IN_COMBAT;
+    isRollingDice = false;
+    showingItemPrompt = false;
+    currentItem = nullptr;
+    gameOver = false;
+}
+
+std::string GameSimulation::getSavePath() const {
+    // Recorded and replayed runs keep to a save of their own
+    return replay.getMode() == ReplayLog::Mode::OFF ? SaveGame::DEFAULT_PATH : replay.getSavePath();
+}
+
+void GameSimulation::saveGame() {
+    if (gameOver || combatState != CombatState::NOT_IN_COMBAT || isRollingDice || showingItemPrompt) {
+        events.publish(SaveFinished{SaveOperation::SAVE, SaveResult::REFUSED, 0.0f});
+        return;
+    }
+
+    const int64_t begin = Tracer::now();
+    const bool saved = SaveGame::Write(getSavePath(), *player, *gameMap, getRun());
+    events.publish(SaveFinished{SaveOperation::SAVE, saved ? SaveResult::DONE : SaveResult::FAILED,
+                                (Tracer::now() - begin) / 1e6f});
+}
+
+void GameSimulation::loadGame() {
+    if (returnToMenu) return;  // The screen is already on its way out
+
+    const int64_t begin = Tracer::now();
+    SaveGame::Run run;
+    std::unique_ptr<Character> loadedPlayer;
+    std::unique_ptr<Map> loadedMap;
+    if (!SaveGame::Read(getSavePath(), loadedPlayer, loadedMap, run) ||
+        run.characterClass < 0 || run.characterClass > 2) {
+        events.publish(SaveFinished{SaveOperation::LOAD, SaveResult::FAILED, 0.0f});
+        return;
+    }
+
+    // Whatever was going on in the current run ends with it; saves are only
+    // made while exploring
+    resetEncounter();
+    player = std::move(loadedPlayer);
+    gameMap = std::move(loadedMap);
+    player->GetStatNotifier().Subscribe<GameSimulation, &GameSimulation::onStatsChanged>(this);
+    setRun(run);
+    rewind.Reset(*player, *gameMap, run);
+    turnPending = false;
+    statsChanged = true;
+    events.publish(SaveFinished{SaveOperation::LOAD, SaveResult::DONE, (Tracer::now() - begin) / 1e6f});
+}
+
+void GameSimulation::rewindTurns(int turns) {
+    if (returnToMenu) return;  // The screen is already on its way out
+
+    // Restored states are always between turns, so a battle in progress ends
+    const int64_t begin = Tracer::now();
+    SaveGame::Run run = getRun();
+    const int undone = rewind.Rewind(turns, *player, *gameMap, run);
+    if (undone > 0) {
+        setRun(run);
+        resetEncounter();
+        statsChanged = true;
+    }
+    turnPending = false;
+    events.publish(TurnsRewound{undone, (Tracer::now() - begin) / 1e6f});
+}
+
+void GameSimulation::endTurn() {
+    if (turnPending) {
+        rewind.CommitTurn(*player, *gameMap, getRun());
+        turnPending = false;
+    }
+    replay.endTurn(turnSteps, gameMap->GetStateHash(*player));
+    turnSteps = 0;
+}
+
+bool GameSimulation::playReplayKeys() {
+    bool played = false;
+    int key = 0;
+    while (replay.nextKey(turnSteps, key)) {
+        sf::Event event;
+        event.type = sf::Event::KeyPressed;
+        event.key = sf::Event::KeyEvent();
+        event.key.code = static_cast<sf::Keyboard::Key>(key);
+        handleEvent(event);
+        played = true;
+    }
+    return played;
+}
+
+void GameSimulation::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::BackSpace) {
+        rewindTurns(1);  // Also takes back a lost battle
+        return;
+    }
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F5) {
+        saveGame();
+        return;
+    }
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F8) {
+        loadGame();  // Also restarts a lost run from the last save
+        return;
+    }
+
+    if (event.type == sf::Event::KeyPressed) {
+        turnPending = true;  // Recorded once it has played out, if anything changed
+    }
+
+    if (gameOver) {
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Return) {
+            returnToMenu = true;  // Back to class selection
+        }
+        return;
+    }
+
+    if (event.type == sf::Event::KeyPressed) {
+        // Handle inventory hotkeys (1-4) - allow using items anytime
+        if (event.key.code >= sf::Keyboard::Num1 && event.key.code <= sf::Keyboard::Num4) {
+            int index = event.key.code - sf::Keyboard::Num1;
+            handleItemUse(index);
+            return;
+        }
+
+        if (combatState != CombatState::NOT_IN_COMBAT) {
+            if (combatState == CombatState::PLAYER_TURN) {
+                if (event.key.code == sf::Keyboard::A) {
+                    handlePlayerAttack();
+                }
+                else if (event.key.code == sf::Keyboard::E) {
+                    handlePlayerEscape();
+                }
+                else if (event.key.code == sf::Keyboard::I) {
+                    events.publish(InventoryShown{player.get()});
+                }
+                else if (event.key.code == sf::Keyboard::S && !player->HasUsedAbility()) {
+                    handlePlayerAbility();
+                }
+            }
+            return;
+        }
+
+        // Handle item interaction
+        if (showingItemPrompt) {
+            if (event.key.code == sf::Keyboard::P) {
+                handleItemPickup();
+                return;
+            } else if (event.key.code == sf::Keyboard::L) {
+                // Remove item from map but don't add to inventory
+                events.publish(ItemLeft{currentItem.get()});
+                gameMap->RemoveItemAtPosition(player->GetX(), player->GetY());
+                showingItemPrompt = false;
+                currentItem = nullptr;
+                return;
+            }
+            return;
+        }
+
+        // Handle movement
+        if (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right ||
+            event.key.code == sf::Keyboard::Up || event.key.code == sf::Keyboard::Down) {
+            int dx = 0, dy = 0;
+            if (event.key.code == sf::Keyboard::Left)  dx = -1;
+            else if (event.key.code == sf::Keyboard::Right) dx = 1;
+            else if (event.key.code == sf::Keyboard::Up)    dy = -1;
+            else if (event.key.code == sf::Keyboard::Down)  dy = 1;
+
+            Character* enemy = gameMap->CheckNewPosition(*player, dx, dy);
+            if (enemy) {
+                handleCombat(enemy);
+            } else if (dx != 0 || dy != 0) {  // Only move if actually moving
+                int newX = player->GetX() + dx;
+                int newY = player->GetY() + dy;
+                
+                // Check map boundaries and walls
+                if (newX >= 0 && newX < gameMap->GetWidth() && newY >= 0 && newY < gameMap->GetHeight() &&
+                    !gameMap->HasWall(newX, newY)) {
+                    gameMap->MoveCharacter(*player, dx, dy);
+                    // Move monsters after player's turn
+                    gameMap->MoveMonsters(*player);
+                    events.publish(PlayerMoved{player->GetX(), player->GetY()});
+                }
+            }
+
+            return;
+        }
+    }
+}
+
+void GameSimulation::handleCombat(Character* enemy) {
+    // Combat actions arrive as key presses through handleEvent(); this only starts a battle
+    if (!enemy || combatState != CombatState::NOT_IN_COMBAT) return;
+
+    currentEnemy = enemy;
+    combatState = CombatState::PLAYER_TURN;
+    player->ResetAbility(); // Reset ability at the start of combat
+
+    events.publish(BattleStart{player.get(), enemy});
+    showCombatOptions(true);
+}
+
+void GameSimulation::handleEnemyTurn(Character* enemy) {
+    TraceScope scope("Enemy turn");
+    if (!enemy) return;
+    
+    // Apply status effects first: bleed and burn tick once per enemy turn
+    if (enemy->IsBurning()) {
+        events.publish(StatusDamage{enemy, StatusEffectType::BURN,
+                                    enemy->GetEffects().GetMagnitude(StatusEffectType::BURN)});
+    }
+    StatusEffectScheduler::Instance().AdvanceTurn();
+
+    if (enemy->IsDefeated()) {
+        handleVictory(*enemy);
+        return;
+    }
+    
+    events.publish(EnemyTurnStarted{enemy});
+    int damage = enemy->GetAttack();
+    int actualDamage = player->TakeDamage(damage, diceRng);
+    
+    if (actualDamage > 0) {
+        events.publish(DamageDealt{Combatant::ENEMY, enemy, player.get(), actualDamage, AttackKind::NORMAL, 0, nullptr, 0.0f});
+    } else {
+        events.publish(Dodged{Combatant::PLAYER, enemy, player.get()});
+    }
+    
+    if (player->IsDefeated()) {
+        events.publish(BattleEnd{enemy, BattleOutcome::LOST});
+        gameOver = true;
+        return;
+    }
+    
+    // Deactivate Rage after enemy's turn if it was active
+    if (player->IsRageActive()) {
+        player->DeactivateRage();
+    }
+    
+    combatState = CombatState::PLAYER_TURN;
+    showCombatOptions(true);
+}
+
+void GameSimulation::handleVictory(Character& enemy) {
+    TraceScope scope("Victory");
+    events.publish(BattleEnd{&enemy, BattleOutcome::WON});
+    
+    int previousLevel = player->GetLevel();
+    Battle::Reward(*player, enemy);
+    for (int level = previousLevel + 1; level <= player->GetLevel(); ++level) {
+        events.publish(LevelUp{player.get(), level});
+    }
+
+    bool bossDefeated = enemy.GetBoss();
+    enemy.GetEffects().Clear();  // Stop burn ticks on the defeated enemy
+    gameMap->RemoveEnemy(enemy, 0, 0);
+    
+    if (bossDefeated) {
+        gameOver = true;
+        returnToMenu = true;  // Back to class selection
+    }
+    
+    combatState = CombatState::NOT_IN_COMBAT;
+    currentEnemy = nullptr;
+}
+
+void GameSimulation::handlePlayerAttack() {
+    if (!currentEnemy) return;
+    
+    // If Rage is active, skip dice roll and perform critical hit immediately
+    if (player->IsRageActive()) {
+        events.publish(DiceRolled{0, DiceOutcome::RAGE_CRITICAL_HIT});
+        performPlayerAttack(true);  // Force critical hit
+        player->DeactivateRage();  // Consume Rage after use
+        return;
+    }
+    
+    startDiceRoll();
+}
+
+void GameSimulation::handlePlayerEscape() {
+    if (!currentEnemy) return;
+    combatState = CombatState::TRYING_ESCAPE;
+    startDiceRoll();
+}
+
+void GameSimulation::startDiceRoll() {
+    isRollingDice = true;
+    diceAnimationTime = 0;
+}
+
+void GameSimulation::updateDiceRoll(float deltaTime) {
+    if (!isRollingDice) return;
+
+    diceAnimationTime += deltaTime;
+    
+    // Update dice value rapidly during animation
+    if (diceAnimationTime < 1.0f) {  // Roll for 1 second
+        // If rage is active, show only high numbers during animation for effect
+        if (player->IsRageActive()) {
+            currentDiceValue = 20;
+        } else {
+            currentDiceValue = rollD20();
+        }
+    } else {
+        isRollingDice = false;
+        
+        // Handle the result based on current action
+        if (combatState == CombatState::PLAYER_TURN) {
+            handleDiceResult(currentDiceValue, true);  // true for attack
+        } else if (combatState == CombatState::TRYING_ESCAPE) {
+            handleDiceResult(currentDiceValue, false);  // false for escape
+        }
+    }
+}
+
+void GameSimulation::handleDiceResult(int roll, bool isAttack) {
+    TraceScope scope("Resolve dice roll");
+    if (isAttack) {
+        // If Rage is active, force critical hit and deactivate rage
+        if (player->IsRageActive()) {
+            events.publish(DiceRolled{roll, DiceOutcome::RAGE_CRITICAL_HIT});
+            performPlayerAttack(true);  // Force critical hit
+            player->DeactivateRage();  // Deactivate rage after use
+            return;
+        }
+        
+        // Normal attack resolution
+        if (roll == 20) {
+            events.publish(DiceRolled{roll, DiceOutcome::CRITICAL_HIT});
+            performPlayerAttack(true);
+        } else if (roll == 1 && !player->HasMarker()) {
+            events.publish(DiceRolled{roll, DiceOutcome::CRITICAL_MISS});
+            player->SetWounded(true);
+            combatState = CombatState::ENEMY_TURN;
+            sf::sleep(sf::milliseconds(500));
+            handleEnemyTurn(currentEnemy);
+        } else if (roll >= 10 || player->HasMarker()) {
+            events.publish(DiceRolled{roll, player->HasMarker() ? DiceOutcome::MARKED_HIT : DiceOutcome::HIT});
+            performPlayerAttack(false);
+            
+            if (player->HasMarker()) {
+                player->DecrementMarker();
+            }
+        } else {
+            events.publish(DiceRolled{roll, DiceOutcome::MISS});
+            combatState = CombatState::ENEMY_TURN;
+            sf::sleep(sf::milliseconds(500));
+            handleEnemyTurn(currentEnemy);
+        }
+    } else {
+        // Escape logic remains unchanged
+        if (roll >= 10) {
+            events.publish(EscapeAttempted{roll, true});
+            events.publish(BattleEnd{currentEnemy, BattleOutcome::ESCAPED});
+            // Burn ticks on every enemy turn, fought or not; it goes out with the fight
+            currentEnemy->GetEffects().Remove(StatusEffectType::BURN);
+            combatState = CombatState::NOT_IN_COMBAT;
+            currentEnemy = nullptr;
+            player->SetWounded(false);  // Clear wounded condition after escaping
+        } else {
+            events.publish(EscapeAttempted{roll, false});
+            combatState = CombatState::ENEMY_TURN;
+            sf::sleep(sf::milliseconds(500));
+            handleEnemyTurn(currentEnemy);
+        }
+    }
+}
+
+void GameSimulation::performPlayerAttack(bool isCritical) {
+    TraceScope scope("Player attack");
+    if (!currentEnemy) return;
+    
+    int damage = player->GetTotalAttack(); // Use total attack including weapon bonus
+    if (isCritical) {
+        damage *= 2;  // Double damage on critical hit
+    }
+    
+    int actualDamage = currentEnemy->TakeDamage(damage, diceRng);
+    
+    if (actualDamage > 0) {
+        events.publish(DamageDealt{Combatant::PLAYER, player.get(), currentEnemy, actualDamage,
+                                   isCritical ? AttackKind::CRITICAL : AttackKind::NORMAL,
+                                   player->GetMarkerCount(), player->GetEquippedWeapon().get(), 0.0f});
+    } else {
+        events.publish(Dodged{Combatant::ENEMY, player.get(), currentEnemy});
+    }
+    
+    if (currentEnemy->IsDefeated()) {
+        handleVictory(*currentEnemy);
+        player->SetWounded(false);  // Clear wounded condition after victory
+        return;
+    }
+    
+    combatState = CombatState::ENEMY_TURN;
+    sf::sleep(sf::milliseconds(500));
+    handleEnemyTurn(currentEnemy);
+}
+
+void GameSimulation::checkForItems() {
+    if (showingItemPrompt) return; // Don't check for items if we're already showing a prompt
+
+    auto item = gameMap->GetItemAtPosition(player->GetX(), player->GetY());
+    if (item) {
+        currentItem = item;
+        showingItemPrompt = true;
+        events.publish(ItemFound{item.get()});
+    }
+}
+
+void GameSimulation::handleItemPickup() {
+    if (!currentItem || !showingItemPrompt) return;
+
+    // Try to add item to inventory
+    if (player->AddItem(currentItem)) {
+        // Successfully added to inventory, remove from map
+        gameMap->RemoveItemAtPosition(player->GetX(), player->GetY());
+        events.publish(ItemPicked{currentItem.get(), true});
+        showingItemPrompt = false;
+        currentItem = nullptr;
+    } else {
+        events.publish(ItemPicked{currentItem.get(), false});
+    }
+}
+
+void GameSimulation::handleItemUse(int index) {
+    const auto& inventory = player->GetInventory();
+    if (index < 0 || static_cast<size_t>(index) >= inventory.size()) return;
+
+    auto item = inventory[index];
+
+    switch (item->GetType()) {
+        case ItemType::POTION:
+            if (item->GetName().find("Health") != std::string::npos || item->GetName() == "Apple") {
+                int healAmount = item->GetEffectValue();
+                int oldHealth = player->GetHealth();
+                int maxHeal = player->GetMaxHealth() - oldHealth;
+                int actualHeal = std::min(healAmount, maxHeal);
+                
+                if (actualHeal > 0) {
+                    player->TakeDamage(-actualHeal, diceRng); // Use actualHeal instead of healAmount
+                    player->RemoveItem(index);
+                    events.publish(ItemUsed{player.get(), item.get(), ItemUseResult::HEALED, actualHeal});
+                } else {
+                    events.publish(ItemUsed{player.get(), item.get(), ItemUseResult::ALREADY_FULL_HEALTH, 0});
+                }
+            } else if (item->GetName().find("Strength") != std::string::npos) {
+                // Handle strength potion
+                int strengthBonus = item->GetEffectValue();
+                player->ApplyStrengthBuff(strengthBonus);
+                player->RemoveItem(index);
+                events.publish(ItemUsed{player.get(), item.get(), ItemUseResult::STRENGTHENED, strengthBonus});
+            }
+            break;
+
+        case ItemType::WEAPON:
+            player->EquipWeapon(index);
+            events.publish(ItemUsed{player.get(), item.get(), ItemUseResult::EQUIPPED, item->GetEffectValue()});
+            break;
+
+        case ItemType::OBJECT:
+            // Handle object effects based on type
+            switch (item->GetObjectEffect()) {
+                case ObjectEffect::REVEAL_BOSS:
+                    bossRevealed = true;
+                    break;
+                case ObjectEffect::REVEAL_ITEMS:
+                    itemsRevealed = true;
+                    break;
+                case ObjectEffect::REVEAL_MONSTERS:
+                    monstersRevealed = true;
+                    break;
+            }
+            player->RemoveItem(index);
+            events.publish(ItemUsed{player.get(), item.get(), ItemUseResult::REVEALED, 0});
+            break;
+    }
+
+    // If in combat, show combat options again after using item
+    if (combatState == CombatState::PLAYER_TURN) {
+        showCombatOptions(false);
+    }
+}
+
+void GameSimulation::handlePlayerAbility() {
+    if (!currentEnemy || player->HasUsedAbility()) return;
+ 
+    switch (selectedCharacter) {
+        case 0: // Knight
+            performRageAbility();
+            // Knight should NOT go to enemy turn, just activate rage and wait for next attack
+            break;
+        case 1: // Mage
+            performFireballAbility();
+            break;
+        case 2: // Archer
+            performHeadshotAbility();
+            // Archer waits for next turn
+            combatState = CombatState::ENEMY_TURN;
+            sf::sleep(sf::milliseconds(500));
+            handleEnemyTurn(currentEnemy);
+            break;
+    }
+}
+
+void GameSimulation::performRageAbility() {
+    player->ActivateRage();
+    player->SetAbilityUsed(true);  // Mark ability as used
+    events.publish(AbilityUsed{Ability::RAGE});
+    // Show combat options again since we're staying in player turn
+    showCombatOptions(false);
+}
+
+void GameSimulation::performFireballAbility() {
+    // Calculate 15% of enemy's max health for Fireball damage
+    float damagePercent = 0.15f;  // 15%
+    int maxHealth = currentEnemy->GetMaxHealth();
+    int burnDamage = static_cast<int>(maxHealth * damagePercent);
+    
+    // Ensure minimum damage of 1
+    burnDamage = std::max(1, burnDamage);
+    
+    int actualDamage = currentEnemy->TakeDamage(burnDamage, diceRng);
+    currentEnemy->ApplyBurn();
+    player->SetAbilityUsed(true);
+    
+    events.publish(AbilityUsed{Ability::FIREBALL});
+    events.publish(DamageDealt{Combatant::PLAYER, player.get(), currentEnemy, actualDamage, AttackKind::FIREBALL, 0, nullptr,
+                               damagePercent});
+    
+    if (currentEnemy->IsDefeated()) {
+        handleVictory(*currentEnemy);
+        return;
+    }
+    
+    combatState = CombatState::ENEMY_TURN;
+    sf::sleep(sf::milliseconds(500));
+    handleEnemyTurn(currentEnemy);
+}
+
+void GameSimulation::performHeadshotAbility() {
+    player->ActivateMarker();
+    events.publish(AbilityUsed{Ability::HUNTERS_MARK});
+}
+
+const char* GameSimulation::getAbilityDescription() const {
+    switch (selectedCharacter) {
+        case 0: // Knight
+            return "Rage (Next attack is a critical hit)";
+        case 1: // Mage
+            return "Fireball (15% max HP damage + 5 damage/turn)";
+        case 2: // Archer
+            return "Hunter's Mark (Next 3 attacks cannot miss)";
+        default:
+            return "";
+    }
+}
@@ -0,0 +1,206 @@
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace {
+
+const size_t RING_CAPACITY = 4096;              // Must be a power of two
+const size_t MAX_FILE_BYTES = 1024 * 1024;      // Rotate after 1 MiB
+const int KEPT_FILES = 3;                       // FightGPT.log.1 .. FightGPT.log.3
+const char* LOG_DIRECTORY = "logs";
+const char* LOG_FILE = "logs/FightGPT.log";
+
+const char* LevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::ERROR: return "ERROR";
+    }
+    return "?";
+}
+
+// Bounded multi-producer ring (Vyukov): producers claim a cell with one CAS,
+// fill it and publish it by bumping its sequence. A single background thread
+// drains cells in order and writes them to rotating files.
+class LogWriter {
+public:
+    LogWriter() : cells(new Cell[RING_CAPACITY]) {
+        for (size_t i = 0; i < RING_CAPACITY; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        thread = std::thread([this] { run(); });
+    }
+
+    LogRecord* acquire() {
+        if (stopped.load(std::memory_order_relaxed)) return nullptr;
+
+        uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & (RING_CAPACITY - 1)];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.record.position = position;
+                    cell.record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+                    cell.record.thread = Logger::threadId();
+                    return &cell.record;
+                }
+            } else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(LogRecord* record) {
+        cells[record->position & (RING_CAPACITY - 1)].sequence.store(record->position + 1, std::memory_order_release);
+    }
+
+    void flush() {
+        uint64_t target = enqueuePosition.load(std::memory_order_acquire);
+        while (writtenPosition.load(std::memory_order_acquire) < target && !stopped.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void stop() {
+        if (stopped.exchange(true)) return;
+        thread.join();
+        drain();  // Whatever arrived while the thread was exiting
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        LogRecord record;
+    };
+
+    void run() {
+        shiftFiles();  // The previous session's log, a crash log included, becomes FightGPT.log.1
+        openFile();
+        while (!stopped.load(std::memory_order_relaxed)) {
+            if (drain() == 0) {
+                if (file) std::fflush(file);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    size_t drain() {
+        size_t count = 0;
+        for (;;) {
+            Cell& cell = cells[dequeuePosition & (RING_CAPACITY - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) break;
+
+            write(cell.record);
+            cell.sequence.store(dequeuePosition + RING_CAPACITY, std::memory_order_release);
+            ++dequeuePosition;
+            ++count;
+        }
+        writtenPosition.store(dequeuePosition, std::memory_order_release);
+
+        uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost > 0 && file) {
+            fileBytes += std::fprintf(file, "[logger] dropped %llu records (ring full)\n",
+                                      static_cast<unsigned long long>(lost));
+        }
+        return count;
+    }
+
+    void write(const LogRecord& record) {
+        std::time_t seconds = static_cast<std::time_t>(record.timestamp / 1000000000);
+        int millis = static_cast<int>((record.timestamp / 1000000) % 1000);
+        std::tm local = *std::localtime(&seconds);
+        char timestamp[32];
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &local);
+
+        if (record.level == LogLevel::ERROR) {
+            std::fprintf(stderr, "[%s] [ERROR] %.*s\n", timestamp, record.length, record.text);
+        }
+        if (!file) return;
+
+        int written = std::fprintf(file, "[%s.%03d] [%s] [T%u] %.*s\n", timestamp, millis,
+                                   LevelName(record.level), record.thread, record.length, record.text);
+        if (written > 0) fileBytes += written;
+        if (fileBytes >= MAX_FILE_BYTES) rotate();
+    }
+
+    void openFile() {
+        std::error_code ignored;
+        std::filesystem::create_directories(LOG_DIRECTORY, ignored);
+        file = std::fopen(LOG_FILE, "w");
+        fileBytes = 0;
+        if (!file) {
+            std::fprintf(stderr, "Failed to open %s, file logging disabled\n", LOG_FILE);
+        }
+    }
+
+    void rotate() {
+        std::fclose(file);
+        shiftFiles();
+        openFile();
+    }
+
+    void shiftFiles() {
+        std::string base = LOG_FILE;
+        std::remove((base + "." + std::to_string(KEPT_FILES)).c_str());
+        for (int i = KEPT_FILES - 1; i >= 1; --i) {
+            std::rename((base + "." + std::to_string(i)).c_str(), (base + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(base.c_str(), (base + ".1").c_str());
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<uint64_t> enqueuePosition{0};  // Producers only; kept off the writer's cache line
+    alignas(64) std::atomic<uint64_t> writtenPosition{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> stopped{false};
+    uint64_t dequeuePosition = 0;  // Only touched by the writer thread
+    std::thread thread;
+    FILE* file = nullptr;
+    size_t fileBytes = 0;
+};
+
+LogWriter& Writer() {
+    // Never destroyed: records logged during static destruction are dropped
+    // instead of touching a dead object. The exit hook drains and closes.
+    static LogWriter* writer = [] {
+        auto* instance = new LogWriter();
+        std::atexit([] { Writer().stop(); });
+        return instance;
+    }();
+    return *writer;
+}
+
+}  // namespace
+
+LogRecord* Logger::acquire() {
+    return Writer().acquire();
+}
+
+void Logger::publish(LogRecord* record) {
+    Writer().publish(record);
+}
+
+void Logger::flush() {
+    Writer().flush();
+}
+
+uint32_t Logger::threadId() {
+    static std::atomic<uint32_t> nextId{0};
+    thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
@@ -0,0 +1,216 @@
+#include "Minimap.h"
+#include "GameLogic.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+const sf::Color UNEXPLORED_COLOR(25, 25, 25);
+const sf::Color FLOOR_COLOR(90, 90, 90);
+const sf::Color WALL_COLOR(170, 140, 100);
+const sf::Color ITEM_COLOR(255, 215, 0);
+const sf::Color MONSTER_COLOR(220, 40, 40);
+const sf::Color BOSS_COLOR(255, 0, 255);
+const sf::Color PLAYER_COLOR(0, 200, 255);
+}
+
+MinimapFeed::MinimapFeed()
+    : width(0), height(0), built(false), overflowed(false), wallRevision(0), generation(0) {}
+
+MinimapFeed::~MinimapFeed() {
+    delete pendingImage.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void MinimapFeed::update(const Map& map, const MinimapVisibility& visibility) {
+    const bool newMap = map.GetWidth() != width || map.GetHeight() != height || map.GetWallRevision() != wallRevision;
+    const bool newReveal = visibility.bossRevealed != shown.bossRevealed ||
+                           visibility.itemsRevealed != shown.itemsRevealed ||
+                           visibility.monstersRevealed != shown.monstersRevealed;
+    if (!built || overflowed || newMap || newReveal) {
+        shown = visibility;
+        rebuild(map);
+        return;
+    }
+
+    // The old sight square drops the markers only visible up close and the new
+    // one is explored; everything else keeps its texels
+    if (visibility.playerX != shown.playerX || visibility.playerY != shown.playerY ||
+        visibility.sightRadius != shown.sightRadius) {
+        const MinimapVisibility previous = shown;
+        shown = visibility;
+        exploreSight(shown.playerX, shown.playerY);
+        refreshArea(map, previous.playerX - previous.sightRadius, previous.playerY - previous.sightRadius,
+                    previous.playerX + previous.sightRadius + 1, previous.playerY + previous.sightRadius + 1);
+        refreshArea(map, shown.playerX - shown.sightRadius, shown.playerY - shown.sightRadius,
+                    shown.playerX + shown.sightRadius + 1, shown.playerY + shown.sightRadius + 1);
+    }
+
+    for (const auto& [x, y] : map.GetChangedCells()) {
+        refreshArea(map, x, y, x + 1, y + 1);
+    }
+}
+
+std::unique_ptr<MinimapFeed::FullImage> MinimapFeed::takeImage() {
+    return std::unique_ptr<FullImage>(pendingImage.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+void MinimapFeed::rebuild(const Map& map) {
+    if (!built || map.GetWidth() != width || map.GetHeight() != height || map.GetWallRevision() != wallRevision) {
+        width = map.GetWidth();
+        height = map.GetHeight();
+        wallRevision = map.GetWallRevision();
+        explored.assign(static_cast<size_t>(width) * height, false);
+    }
+    exploreSight(shown.playerX, shown.playerY);
+
+    // Texels queued before this generation are dropped by the reader, so the
+    // image has to be published before any texel that applies on top of it
+    auto full = std::make_unique<FullImage>();
+    full->generation = ++generation;
+    full->image.create(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            full->image.setPixel(x, y, cellColor(map, x, y));
+        }
+    }
+    delete pendingImage.exchange(full.release(), std::memory_order_acq_rel);
+
+    overflowed = false;
+    built = true;
+}
+
+void MinimapFeed::refreshArea(const Map& map, int left, int top, int right, int bottom) {
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, width);
+    bottom = std::min(bottom, height);
+
+    MinimapTexel texel;
+    texel.generation = generation;
+    for (int y = top; y < bottom && !overflowed; ++y) {
+        for (int x = left; x < right; ++x) {
+            texel.x = static_cast<uint16_t>(x);
+            texel.y = static_cast<uint16_t>(y);
+            texel.color = cellColor(map, x, y);
+            if (!texels.push(texel)) {
+                // The render thread is far behind; a full image replaces the rest
+                overflowed = true;
+                break;
+            }
+        }
+    }
+}
+
+void MinimapFeed::exploreSight(int centreX, int centreY) {
+    const int radius = shown.sightRadius;
+    for (int y = std::max(0, centreY - radius); y <= std::min(height - 1, centreY + radius); ++y) {
+        for (int x = std::max(0, centreX - radius); x <= std::min(width - 1, centreX + radius); ++x) {
+            explored[static_cast<size_t>(y) * width + x] = true;
+        }
+    }
+}
+
+sf::Color MinimapFeed::cellColor(const Map& map, int x, int y) const {
+    if (x == shown.playerX && y == shown.playerY) return PLAYER_COLOR;
+
+    const bool inSight = std::abs(x - shown.playerX) <= shown.sightRadius &&
+                         std::abs(y - shown.playerY) <= shown.sightRadius;
+    if (const Character* enemy = map.GetCharacterAt(x, y)) {
+        if (enemy->GetBoss() && (inSight || shown.bossRevealed)) return BOSS_COLOR;
+        if (!enemy->GetBoss() && (inSight || shown.monstersRevealed)) return MONSTER_COLOR;
+    }
+    if ((inSight || shown.itemsRevealed) && map.GetItemAtPosition(x, y)) return ITEM_COLOR;
+
+    if (!explored[static_cast<size_t>(y) * width + x]) return UNEXPLORED_COLOR;
+    return map.HasWall(x, y) ? WALL_COLOR : FLOOR_COLOR;
+}
+
+Minimap::Minimap() : scale(1.0f), width(0), height(0), generation(0), runX(0), runY(0) {
+    background.setFillColor(sf::Color(60, 60, 60));
+    background.setOutlineColor(sf::Color(200, 200, 200));
+    background.setOutlineThickness(2);
+
+    cameraOutline.setFillColor(sf::Color::Transparent);
+    cameraOutline.setOutlineColor(sf::Color::White);
+    cameraOutline.setOutlineThickness(1);
+}
+
+void Minimap::setPanel(const sf::FloatRect& minimapPanel) {
+    panel = minimapPanel;
+    background.setPosition(panel.left, panel.top);
+    background.setSize(sf::Vector2f(panel.width, panel.height));
+    placeSprite();
+}
+
+void Minimap::sync(MinimapFeed& feed) {
+    applyImage(feed);
+
+    MinimapTexel texel;
+    while (feed.popTexel(texel)) {
+        // A newer generation means its image was published before this texel
+        if (texel.generation > generation) applyImage(feed);
+        if (texel.generation != generation) continue;
+
+        if (!run.empty() && (texel.y != runY || texel.x != runX + static_cast<int>(run.size() / 4))) {
+            flushRun();
+        }
+        if (run.empty()) {
+            runX = texel.x;
+            runY = texel.y;
+        }
+        run.insert(run.end(), {texel.color.r, texel.color.g, texel.color.b, texel.color.a});
+    }
+    flushRun();
+}
+
+void Minimap::setCameraCells(const sf::IntRect& cells) {
+    const sf::Vector2f origin = sprite.getPosition();
+    cameraOutline.setPosition(origin.x + cells.left * scale, origin.y + cells.top * scale);
+    cameraOutline.setSize(sf::Vector2f(cells.width * scale, cells.height * scale));
+}
+
+void Minimap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(background, states);
+    target.draw(sprite, states);
+    target.draw(cameraOutline, states);
+}
+
+bool Minimap::applyImage(MinimapFeed& feed) {
+    std::unique_ptr<MinimapFeed::FullImage> full = feed.takeImage();
+    if (!full) return false;
+
+    run.clear();  // Older texels are covered by the image
+    generation = full->generation;
+    const sf::Vector2u size = full->image.getSize();
+    if (static_cast<int>(size.x) != width || static_cast<int>(size.y) != height) {
+        width = size.x;
+        height = size.y;
+        if (!texture.create(width, height)) {
+            Logger::error("Failed to create ", width, "x", height, " minimap texture!");
+        }
+        sprite.setTexture(texture, true);
+        placeSprite();
+    }
+    if (texture.getSize().x > 0) {
+        texture.update(full->image);
+    }
+    return true;
+}
+
+void Minimap::placeSprite() {
+    if (width == 0 || height == 0) return;
+
+    // Scaled to fit the panel, keeping cells square, and centred
+    scale = std::min(panel.width / width, panel.height / height);
+    sprite.setScale(scale, scale);
+    sprite.setPosition(panel.left + (panel.width - width * scale) / 2,
+                       panel.top + (panel.height - height * scale) / 2);
+}
+
+void Minimap::flushRun() {
+    if (run.empty()) return;
+    if (texture.getSize().x > 0) {
+        texture.update(run.data(), static_cast<unsigned>(run.size() / 4), 1, runX, runY);
+    }
+    run.clear();
+}
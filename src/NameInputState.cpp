@@ -1,33 +1,28 @@
 #include "NameInputState.h"
 #include "CharacterSelectionState.h"
+#include "AssetCache.h"
 #include "Logger.h"
+#include "TextureAtlas.h"
 
-NameInputState::NameInputState() : windowWidth(1200), windowHeight(800), playerName("") {
-    if (!font.loadFromFile("assets/fonts/Jersey15-Regular.ttf")) {
-        Logger::error("Failed to load font!");
-        return;
-    }
+NameInputState::NameInputState() : windowWidth(1200), windowHeight(800), logoShown(false), playerName("") {
+    font = AssetCache::Instance().getFont(AssetCache::DEFAULT_FONT_PATH);
 
-    // Load logo
-    if (!logoTexture.loadFromFile("assets/logo.png")) {
-        Logger::error("Failed to load logo!");
-    } else {
-        logoSprite.setTexture(logoTexture);
-        // Scale logo to reasonable size (300px width)
-        float scaleX = 300.0f / logoTexture.getSize().x;
-        float scaleY = 300.0f / logoTexture.getSize().y;
-        logoSprite.setScale(scaleX, scaleY);
-        float logoY = 50.f;  // Move logo higher up
-        logoSprite.setPosition((windowWidth - logoSprite.getGlobalBounds().width) / 2.f, logoY);
+    // The sprite atlas decodes in the background while the name is typed;
+    // the logo (baked at 300x300) appears once it is uploaded
+    TextureAtlas::Instance().preload();
+    const SpriteAtlas::Rect& logoRect = SpriteAtlas::GetRect(SpriteAtlas::Sprite::LOGO);
+    float logoY = 50.f;  // Move logo higher up
+    logoSprite.setPosition((windowWidth - static_cast<float>(logoRect.width)) / 2.f, logoY);
+    loadingBar.setPosition(logoSprite.getPosition().x, logoY + logoRect.height / 2.f);
+    loadingBar.setFillColor(sf::Color(255, 215, 0));
 
-        // Set up title (now positioned below logo)
-        titleText.setFont(font);
-        titleText.setString("Enter the name");
-        titleText.setCharacterSize(40);
-        titleText.setFillColor(sf::Color(255, 215, 0));  // Gold color
-        float titleY = logoY + logoSprite.getGlobalBounds().height + 50.f;  // Add spacing after logo
-        titleText.setPosition((windowWidth - titleText.getGlobalBounds().width) / 2.f, titleY);
-    }
+    // Set up title (now positioned below logo)
+    titleText.setFont(*font);
+    titleText.setString("Enter the name");
+    titleText.setCharacterSize(40);
+    titleText.setFillColor(sf::Color(255, 215, 0));  // Gold color
+    float titleY = logoY + logoRect.height + 50.f;  // Add spacing after logo
+    titleText.setPosition((windowWidth - titleText.getGlobalBounds().width) / 2.f, titleY);
     
     // Set up input box
     inputBox.setSize(sf::Vector2f(400, 50));
@@ -36,12 +31,12 @@ NameInputState::NameInputState() : windowWidth(1200), windowHeight(800), playerN
     inputBox.setOutlineThickness(2);
     
     // Set up input text
-    inputText.setFont(font);
+    inputText.setFont(*font);
     inputText.setCharacterSize(32);
     inputText.setFillColor(sf::Color::White);
     
     // Set up instruction text
-    instructionText.setFont(font);
+    instructionText.setFont(*font);
     instructionText.setString("Press Enter to confirm");
     instructionText.setCharacterSize(24);
     instructionText.setFillColor(sf::Color(255, 215, 0));  // Gold color to match title
@@ -66,14 +61,30 @@ void NameInputState::handleEvent(const sf::Event& event, sf::RenderWindow& /*win
     }
     else if (event.type == sf::Event::KeyPressed) {
         if (event.key.code == sf::Keyboard::Return && !playerName.empty()) {
-            Logger::info("Player name set to: " + playerName);
-            nextState = std::make_unique<CharacterSelectionState>(playerName);
+            Logger::info("Player name set to: ", playerName);
+            pushState(std::make_unique<CharacterSelectionState>(playerName));
         }
     }
 }
 
 void NameInputState::update(float /*deltaTime*/) {
-    // No update needed
+    if (logoShown) return;
+    if (TextureAtlas::Instance().isReady()) {
+        showLogo();
+        return;
+    }
+    const SpriteAtlas::Rect& logoRect = SpriteAtlas::GetRect(SpriteAtlas::Sprite::LOGO);
+    loadingBar.setSize(sf::Vector2f(logoRect.width * AssetCache::Instance().getProgress(), 4.f));
+}
+
+void NameInputState::showLogo() {
+    logoShown = true;
+    requestRedraw();
+    if (!TextureAtlas::Instance().load()) {
+        Logger::error("Failed to load logo!");
+        return;
+    }
+    TextureAtlas::Instance().apply(logoSprite, SpriteAtlas::Sprite::LOGO);
 }
 
 void NameInputState::updateText() {
@@ -110,7 +121,11 @@ void NameInputState::updateText() {
 void NameInputState::draw(sf::RenderWindow& window) {
     window.clear(sf::Color(40, 40, 40));
     
-    window.draw(logoSprite);
+    if (logoShown) {
+        window.draw(logoSprite);
+    } else {
+        window.draw(loadingBar);
+    }
     window.draw(titleText);
     window.draw(inputBox);
     window.draw(inputText);
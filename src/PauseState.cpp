@@ -0,0 +1,44 @@
+#include "PauseState.h"
+#include "AssetCache.h"
+#include "Logger.h"
+
+PauseState::PauseState() {
+    font = AssetCache::Instance().getFont(AssetCache::DEFAULT_FONT_PATH);
+
+    dim.setSize(sf::Vector2f(1200, 800));  // Window size
+    dim.setFillColor(sf::Color(0, 0, 0, 160));
+
+    title.setFont(*font);
+    title.setString("PAUSED");
+    title.setCharacterSize(72);
+    title.setFillColor(sf::Color(255, 215, 0));  // Gold color
+    sf::FloatRect titleBounds = title.getLocalBounds();
+    title.setPosition((1200 - titleBounds.width) / 2.0f, 300);
+
+    instructions.setFont(*font);
+    instructions.setString("Space: Resume    Q: Back to class selection");
+    instructions.setCharacterSize(24);
+    instructions.setFillColor(sf::Color::White);
+    sf::FloatRect instructionBounds = instructions.getLocalBounds();
+    instructions.setPosition((1200 - instructionBounds.width) / 2.0f, 400);
+}
+
+void PauseState::handleEvent(const sf::Event& event, sf::RenderWindow& /*window*/) {
+    if (event.type != sf::Event::KeyPressed) return;
+    if (event.key.code == sf::Keyboard::Space) {
+        popState();
+    } else if (event.key.code == sf::Keyboard::Q) {
+        Logger::info("Run abandoned from the pause screen");
+        popState(2);  // This screen and the game under it
+    }
+}
+
+void PauseState::update(float /*deltaTime*/) {
+    // Nothing moves while paused
+}
+
+void PauseState::draw(sf::RenderWindow& window) {
+    window.draw(dim);
+    window.draw(title);
+    window.draw(instructions);
+}
@@ -0,0 +1,51 @@
+#include "Profiler.h"
+#include <algorithm>
+
+Profiler& Profiler::Instance() {
+    // Never destroyed so threads can still record during shutdown
+    static Profiler* profiler = new Profiler();
+    return *profiler;
+}
+
+size_t Profiler::copyHistory(ProfilePhase phase, std::array<uint32_t, HISTORY>& samples) const {
+    const Ring& ring = rings[static_cast<size_t>(phase)];
+    const uint64_t count = ring.count.load(std::memory_order_relaxed);
+    const size_t kept = static_cast<size_t>(std::min<uint64_t>(count, HISTORY));
+    const uint64_t first = count - kept;
+    for (size_t i = 0; i < kept; ++i) {
+        samples[i] = ring.samples[(first + i) % HISTORY].load(std::memory_order_relaxed);
+    }
+    return kept;
+}
+
+Profiler::PhaseStats Profiler::getStats(ProfilePhase phase) const {
+    std::array<uint32_t, HISTORY> samples;
+    PhaseStats stats;
+    stats.samples = copyHistory(phase, samples);
+    if (stats.samples == 0) return stats;
+
+    auto begin = samples.begin();
+    auto end = begin + stats.samples;
+    stats.max = *std::max_element(begin, end);
+    std::nth_element(begin, begin + stats.samples / 2, end);
+    stats.p50 = begin[stats.samples / 2];
+    const size_t p99Index = std::min(stats.samples - 1, stats.samples * 99 / 100);
+    std::nth_element(begin, begin + p99Index, end);
+    stats.p99 = begin[p99Index];
+    return stats;
+}
+
+const char* Profiler::getPhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::FRAME: return "Frame";
+        case ProfilePhase::EVENTS: return "Events";
+        case ProfilePhase::UPDATE: return "Update";
+        case ProfilePhase::DRAW: return "Draw";
+        case ProfilePhase::DISPLAY: return "Display";
+        case ProfilePhase::DRAW_GRID: return "Draw grid";
+        case ProfilePhase::COMBAT_LOG: return "Combat log";
+        case ProfilePhase::SIMULATION: return "Sim step";
+        case ProfilePhase::MOVE_MONSTERS: return "Move monsters";
+        default: return "?";
+    }
+}
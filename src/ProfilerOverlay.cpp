@@ -0,0 +1,120 @@
+#include "ProfilerOverlay.h"
+#include "AssetCache.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+const float LEFT = 10.0f;
+const float TOP = 10.0f;
+const float WIDTH = 300.0f;
+const float PADDING = 8.0f;
+const unsigned TEXT_SIZE = 14;
+const float COLUMN_X[] = {0.0f, 120.0f, 180.0f, 240.0f};
+
+void appendMilliseconds(std::string& text, uint32_t microseconds, size_t samples) {
+    char buffer[16];
+    if (samples == 0) {
+        text += "-";
+        return;
+    }
+    std::snprintf(buffer, sizeof(buffer), "%.1f", microseconds / 1000.0f);
+    text += buffer;
+}
+}
+
+ProfilerOverlay::ProfilerOverlay() : graph(sf::Quads), graphBottom(0), visible(false), sinceRefresh(0) {
+    font = AssetCache::Instance().getFont(AssetCache::DEFAULT_FONT_PATH);
+
+    const float lineSpacing = font->getLineSpacing(TEXT_SIZE);
+    const float tableHeight = lineSpacing * (static_cast<size_t>(ProfilePhase::COUNT) + 1);
+    background.setPosition(LEFT, TOP);
+    background.setSize(sf::Vector2f(WIDTH, tableHeight + GRAPH_HEIGHT + 3 * PADDING));
+    background.setFillColor(sf::Color(0, 0, 0, 200));
+
+    for (size_t i = 0; i < COLUMNS; ++i) {
+        columns[i].setFont(*font);
+        columns[i].setCharacterSize(TEXT_SIZE);
+        columns[i].setFillColor(sf::Color::White);
+        columns[i].setPosition(LEFT + PADDING + COLUMN_X[i], TOP + PADDING);
+    }
+
+    graphBottom = TOP + 2 * PADDING + tableHeight + GRAPH_HEIGHT;
+    budgetLine.setSize(sf::Vector2f(Profiler::HISTORY, 1));
+    budgetLine.setPosition(LEFT + PADDING, graphBottom - GRAPH_HEIGHT * (FRAME_BUDGET_MS / GRAPH_MAX_MS));
+    budgetLine.setFillColor(sf::Color(255, 255, 255, 120));
+}
+
+void ProfilerOverlay::toggle() {
+    visible = !visible;
+    Profiler::Instance().setEnabled(visible);
+    if (visible) {
+        sinceRefresh = REFRESH_SECONDS;  // Fill the table on the next update
+    }
+}
+
+void ProfilerOverlay::update(float deltaTime) {
+    if (!visible) return;
+
+    refreshGraph();
+    sinceRefresh += deltaTime;
+    if (sinceRefresh >= REFRESH_SECONDS) {
+        sinceRefresh = 0;
+        refreshTable();
+    }
+}
+
+void ProfilerOverlay::refreshTable() {
+    const Profiler& profiler = Profiler::Instance();
+    columnStrings[0] = "Phase";
+    columnStrings[1] = "p50";
+    columnStrings[2] = "p99";
+    columnStrings[3] = "max ms";
+    for (size_t i = 0; i < static_cast<size_t>(ProfilePhase::COUNT); ++i) {
+        const ProfilePhase phase = static_cast<ProfilePhase>(i);
+        const Profiler::PhaseStats stats = profiler.getStats(phase);
+        for (std::string& column : columnStrings) {
+            column += "\n";
+        }
+        columnStrings[0] += Profiler::getPhaseName(phase);
+        appendMilliseconds(columnStrings[1], stats.p50, stats.samples);
+        appendMilliseconds(columnStrings[2], stats.p99, stats.samples);
+        appendMilliseconds(columnStrings[3], stats.max, stats.samples);
+    }
+    for (size_t i = 0; i < COLUMNS; ++i) {
+        columns[i].setString(columnStrings[i]);
+    }
+}
+
+void ProfilerOverlay::refreshGraph() {
+    // One bar per frame, newest on the right; green within a 60 Hz frame,
+    // yellow within two and red beyond
+    std::array<uint32_t, Profiler::HISTORY> samples;
+    const size_t count = Profiler::Instance().copyHistory(ProfilePhase::FRAME, samples);
+    const float left = LEFT + PADDING + (Profiler::HISTORY - count);
+
+    graph.resize(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        const float milliseconds = samples[i] / 1000.0f;
+        const float height = std::min(milliseconds / GRAPH_MAX_MS, 1.0f) * GRAPH_HEIGHT;
+        const sf::Color color = milliseconds <= FRAME_BUDGET_MS ? sf::Color(80, 220, 80) :
+                                milliseconds <= GRAPH_MAX_MS ? sf::Color(240, 200, 60) : sf::Color(230, 60, 60);
+        const float x = left + i;
+        sf::Vertex* quad = &graph[i * 4];
+        quad[0] = sf::Vertex(sf::Vector2f(x, graphBottom - height), color);
+        quad[1] = sf::Vertex(sf::Vector2f(x + 1, graphBottom - height), color);
+        quad[2] = sf::Vertex(sf::Vector2f(x + 1, graphBottom), color);
+        quad[3] = sf::Vertex(sf::Vector2f(x, graphBottom), color);
+    }
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!visible) return;
+
+    target.draw(background, states);
+    for (const sf::Text& column : columns) {
+        target.draw(column, states);
+    }
+    target.draw(graph, states);
+    target.draw(budgetLine, states);
+}
@@ -0,0 +1,160 @@
+#include "ReplayLog.h"
+#include "Logger.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Headers and entries are written and read as native structs
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Replay files are little-endian; big-endian targets need byte swapping"
+#endif
+
+namespace {
+
+std::string FormatHash(uint64_t hash) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016" PRIx64, hash);
+    return text;
+}
+
+}  // namespace
+
+const char* ReplayLog::configuredPath() {
+    const char* path = std::getenv("FIGHTGPT_REPLAY");
+    return path && *path ? path : nullptr;
+}
+
+void ReplayLog::open(const std::string& replayPath, Start& start) {
+    close();
+    path = replayPath;
+    savePath = replayPath + ".sav";
+    std::remove(savePath.c_str());
+
+    if (input.open(path)) {
+        // The mapping is page aligned and entries follow the 8-byte aligned header
+        const Header* header = reinterpret_cast<const Header*>(input.data());
+        const size_t size = input.size();
+        if (size < sizeof(Header) || std::memcmp(header->magic, "FGRP", 4) != 0 || header->version != VERSION ||
+            (size - sizeof(Header)) % sizeof(Entry) != 0 || header->characterClass < 0 ||
+            header->characterClass > 2 || header->mapWidth < 3 || header->mapHeight < 3) {
+            Logger::error("Replay file is damaged or from another version, not replaying it: ", path);
+            input.close();
+            return;
+        }
+        start.characterClass = header->characterClass;
+        start.mapWidth = header->mapWidth;
+        start.mapHeight = header->mapHeight;
+        start.mapSeed = header->mapSeed;
+        start.diceSeed = header->diceSeed;
+        entries = reinterpret_cast<const Entry*>(input.data() + sizeof(Header));
+        entryCount = (size - sizeof(Header)) / sizeof(Entry);
+
+        // Keys pressed after the last finished turn have nothing to check against
+        while (entryCount > 0 && entries[entryCount - 1].key != TURN_END) --entryCount;
+        if (entryCount == 0) {
+            Logger::error("Replay file holds no finished turn: ", path);
+            close();
+            return;
+        }
+        mode = Mode::REPLAYING;
+        Logger::info("Replaying ", path);
+        return;
+    }
+
+    output = std::fopen(path.c_str(), "wb");
+    if (!output) {
+        Logger::error("Failed to open replay file ", path);
+        return;
+    }
+    Header header{};
+    std::memcpy(header.magic, "FGRP", 4);
+    header.version = VERSION;
+    header.characterClass = start.characterClass;
+    header.mapWidth = start.mapWidth;
+    header.mapHeight = start.mapHeight;
+    header.mapSeed = start.mapSeed;
+    header.diceSeed = start.diceSeed;
+    if (std::fwrite(&header, sizeof(header), 1, output) != 1) {
+        Logger::error("Failed to write replay file ", path);
+        close();
+        return;
+    }
+    mode = Mode::RECORDING;
+    Logger::info("Recording replay to ", path);
+}
+
+void ReplayLog::close() {
+    if (mode == Mode::REPLAYING && nextEntry < entryCount) {
+        Logger::info("Replay stopped after ", turn, " of its turns");
+    }
+    if (output) {
+        std::fclose(output);
+        output = nullptr;
+    }
+    input.close();
+    entries = nullptr;
+    entryCount = 0;
+    nextEntry = 0;
+    turn = 0;
+    firstDivergedTurn = 0;
+    mode = Mode::OFF;
+}
+
+void ReplayLog::recordKey(uint32_t step, int key) {
+    if (mode == Mode::RECORDING) write(Entry{step, key, 0});
+}
+
+bool ReplayLog::nextKey(uint32_t step, int& key) {
+    if (mode != Mode::REPLAYING || nextEntry == entryCount) return false;
+    const Entry& entry = entries[nextEntry];
+    if (entry.key == TURN_END || entry.step > step) return false;
+    key = entry.key;
+    ++nextEntry;
+    return true;
+}
+
+uint32_t ReplayLog::getNextStep() const {
+    if (mode != Mode::REPLAYING || nextEntry == entryCount) return NO_STEP;
+    return entries[nextEntry].step;
+}
+
+bool ReplayLog::isTurnEndAt(uint32_t step) const {
+    if (mode != Mode::REPLAYING || nextEntry == entryCount) return false;
+    const Entry& entry = entries[nextEntry];
+    return entry.key == TURN_END && entry.step <= step;
+}
+
+void ReplayLog::endTurn(uint32_t step, uint64_t hash) {
+    ++turn;
+    if (mode == Mode::RECORDING) {
+        write(Entry{step, TURN_END, hash});
+        if (output) std::fflush(output);  // A crash keeps every finished turn
+        return;
+    }
+    if (mode != Mode::REPLAYING || nextEntry == entryCount) return;
+
+    const Entry& entry = entries[nextEntry++];
+    if (entry.hash != hash && firstDivergedTurn == 0) {
+        firstDivergedTurn = turn;
+        Logger::error("Replay diverged at turn ", turn, ": state hash ", FormatHash(hash), ", recorded ",
+                      FormatHash(entry.hash));
+    }
+    if (nextEntry == entryCount) finishReplay();
+}
+
+void ReplayLog::write(const Entry& entry) {
+    if (std::fwrite(&entry, sizeof(entry), 1, output) != 1) {
+        Logger::error("Failed to write replay file ", path, ", recording stopped");
+        close();
+    }
+}
+
+void ReplayLog::finishReplay() {
+    if (firstDivergedTurn == 0) {
+        Logger::info("Replay finished: all ", turn, " turns matched");
+    } else {
+        Logger::error("Replay finished: first diverged at turn ", firstDivergedTurn, " of ", turn);
+    }
+    close();  // Input is taken from the player again
+}
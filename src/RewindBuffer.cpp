@@ -0,0 +1,334 @@
+#include "RewindBuffer.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <algorithm>
+
+namespace {
+// EntityField::FLAGS
+constexpr uint32_t ON_MAP = 1;
+constexpr uint32_t ABILITY_USED = 2;
+
+// RunField::REVEALED
+constexpr uint32_t BOSS_REVEALED = 1;
+constexpr uint32_t ITEMS_REVEALED = 2;
+constexpr uint32_t MONSTERS_REVEALED = 4;
+
+constexpr uint8_t NO_ITEM = 0xFF;  // CaptureItem() of an empty cell
+constexpr size_t EFFECT_COUNT = static_cast<size_t>(StatusEffectType::COUNT);
+}  // namespace
+
+RewindBuffer::EntityState RewindBuffer::CaptureEntity(const Character& character, const Map& map) {
+    EntityState entity{};
+    entity[HEALTH] = static_cast<uint32_t>(character.health.Get());
+    entity[MAX_HEALTH] = static_cast<uint32_t>(character.maxHealth.Get());
+    entity[ATTACK] = static_cast<uint32_t>(character.attack.Get());
+    entity[DEFENSE] = static_cast<uint32_t>(character.defense.Get());
+    entity[SPEED] = static_cast<uint32_t>(character.speed.Get());
+    entity[AVOIDANCE] = static_cast<uint32_t>(character.avoidance.Get());
+    entity[LEVEL] = static_cast<uint32_t>(character.level.Get());
+    entity[EXPERIENCE] = static_cast<uint32_t>(character.experience.Get());
+    entity[POSITION] = static_cast<uint32_t>(character.x) | static_cast<uint32_t>(character.y) << 16;
+    entity[FLAGS] = (map.grid[character.x][character.y] == &character ? ON_MAP : 0) |
+                    (character.abilityUsed ? ABILITY_USED : 0);
+
+    for (size_t i = 0; i < character.inventory.size(); ++i) {
+        entity[INVENTORY] |= static_cast<uint32_t>(FindCatalogItem(*character.inventory[i]) + 1) << (8 * i);
+        if (entity[EQUIPPED] == 0 && character.inventory[i] == character.equipped_weapon) {
+            entity[EQUIPPED] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    for (size_t i = 0; i < EFFECT_COUNT; ++i) {
+        const StatusEffectType type = static_cast<StatusEffectType>(i);
+        if (!character.effects.Has(type)) continue;
+        const EffectDuration remaining = character.effects.GetRemainingDuration(type);
+        entity[EFFECTS + 2 * i] = static_cast<uint32_t>(character.effects.GetMagnitude(type)) << 1 | 1;
+        entity[EFFECTS + 2 * i + 1] =
+            static_cast<uint32_t>(remaining.GetTicks()) << 1 | static_cast<uint32_t>(remaining.GetClock());
+    }
+    return entity;
+}
+
+RewindBuffer::RunState RewindBuffer::CaptureRun(const Map& map, const SaveGame::Run& run) {
+    RunState state{};
+    state[REVEALED] = (run.bossRevealed ? BOSS_REVEALED : 0) | (run.itemsRevealed ? ITEMS_REVEALED : 0) |
+                      (run.monstersRevealed ? MONSTERS_REVEALED : 0);
+    state[MAP_RNG_LOW] = static_cast<uint32_t>(map.rng.GetState());
+    state[MAP_RNG_HIGH] = static_cast<uint32_t>(map.rng.GetState() >> 32);
+    state[DICE_RNG_LOW] = static_cast<uint32_t>(run.diceRng.GetState());
+    state[DICE_RNG_HIGH] = static_cast<uint32_t>(run.diceRng.GetState() >> 32);
+    return state;
+}
+
+uint8_t RewindBuffer::CaptureItem(const Map& map, uint32_t cell) {
+    const auto& item = map.item_grid[cell % map.width][cell / map.width];
+    return item ? static_cast<uint8_t>(FindCatalogItem(*item)) : NO_ITEM;
+}
+
+void RewindBuffer::Reset(const Character& player, const Map& map, const SaveGame::Run& run) {
+    state.entities.clear();
+    state.entities.push_back(CaptureEntity(player, map));
+    for (const auto& enemy : map.enemies) {
+        state.entities.push_back(CaptureEntity(*enemy, map));
+    }
+    state.run = CaptureRun(map, run);
+    state.items.clear();
+    for (int x = 0; x < map.width; ++x) {
+        for (int y = 0; y < map.height; ++y) {
+            const uint32_t cell = static_cast<uint32_t>(y) * map.width + x;
+            const uint8_t id = CaptureItem(map, cell);
+            if (id != NO_ITEM) state.items[cell] = id;
+        }
+    }
+    mapWidth = map.width;
+
+    changedCells.clear();
+    records.assign(RECORD_CAPACITY, Record{});
+    turns.assign(TURN_CAPACITY, Turn{});
+    keyframes.clear();
+    keyframes.push_back(Keyframe{0, state});
+    recordCount = 0;
+    firstTurn = 0;
+    currentTurn = 0;
+    touchedFields.assign(state.entities.size(), 0);
+    touchedCells.clear();
+    runTouched = false;
+}
+
+void RewindBuffer::NoteChangedCells(const std::vector<std::pair<int, int>>& cells) {
+    for (const auto& [x, y] : cells) {
+        changedCells.push_back(static_cast<uint32_t>(y) * mapWidth + x);
+    }
+}
+
+bool RewindBuffer::CommitTurn(const Character& player, const Map& map, const SaveGame::Run& run) {
+    if (map.enemies.size() + 1 != state.entities.size() || map.width != mapWidth) {
+        Logger::error("Rewind history does not belong to this map, starting a new one");
+        Reset(player, map, run);
+        return false;
+    }
+
+    const uint64_t firstRecord = recordCount;
+    for (size_t i = 0; i < state.entities.size(); ++i) {
+        const EntityState now = CaptureEntity(i == 0 ? player : *map.enemies[i - 1], map);
+        EntityState& before = state.entities[i];
+        for (size_t field = 0; field < ENTITY_FIELD_COUNT; ++field) {
+            if (now[field] != before[field]) {
+                Append(static_cast<uint32_t>(i), static_cast<uint8_t>(field), now[field] ^ before[field]);
+            }
+        }
+        before = now;
+    }
+
+    const RunState runNow = CaptureRun(map, run);
+    for (size_t field = 0; field < RUN_FIELD_COUNT; ++field) {
+        if (runNow[field] != state.run[field]) {
+            Append(0, static_cast<uint8_t>(RUN_FIELDS + field), runNow[field] ^ state.run[field]);
+        }
+    }
+    state.run = runNow;
+
+    // Only cells the map reported can have gained or lost an item
+    NoteChangedCells(map.changedCells);
+    std::sort(changedCells.begin(), changedCells.end());
+    changedCells.erase(std::unique(changedCells.begin(), changedCells.end()), changedCells.end());
+    for (const uint32_t cell : changedCells) {
+        const uint8_t now = CaptureItem(map, cell);
+        const auto found = state.items.find(cell);
+        const uint8_t before = found != state.items.end() ? found->second : NO_ITEM;
+        if (now == before) continue;
+        Append(cell, ITEM_CELL, static_cast<uint32_t>(now ^ before));
+        if (now == NO_ITEM) {
+            state.items.erase(found);
+        } else {
+            state.items[cell] = now;
+        }
+    }
+    changedCells.clear();
+
+    const uint64_t count = recordCount - firstRecord;
+    if (count == 0) return false;
+    if (count > RECORD_CAPACITY) {
+        Logger::error("Turn changed more than the rewind history holds, starting a new one");
+        Reset(player, map, run);
+        return false;
+    }
+
+    ++currentTurn;
+    turns[currentTurn % TURN_CAPACITY] = Turn{firstRecord, static_cast<uint32_t>(count)};
+    while (currentTurn - firstTurn > TURN_CAPACITY ||
+           turns[(firstTurn + 1) % TURN_CAPACITY].firstRecord + RECORD_CAPACITY < recordCount) {
+        DropOldest();  // Its slot or some of its records were reused
+    }
+    if (currentTurn % KEYFRAME_INTERVAL == 0) {
+        keyframes.push_back(Keyframe{currentTurn, state});
+    }
+    return true;
+}
+
+int RewindBuffer::Rewind(int count, Character& player, Map& map, SaveGame::Run& run) {
+    TraceScope scope("Rewind turns");
+    CommitTurn(player, map, run);
+    if (count <= 0 || currentTurn == firstTurn) return 0;
+    const uint64_t target = currentTurn - std::min<uint64_t>(static_cast<uint64_t>(count), currentTurn - firstTurn);
+
+    auto flipTurn = [this](uint64_t turn) {
+        const Turn& entry = turns[turn % TURN_CAPACITY];
+        for (uint64_t i = 0; i < entry.recordCount; ++i) {
+            Flip(records[(entry.firstRecord + i) % RECORD_CAPACITY]);
+        }
+    };
+
+    // Replay forward from the last keyframe before the target when that is
+    // shorter than undoing every turn back to it
+    const Keyframe* keyframe = nullptr;
+    for (auto it = keyframes.rbegin(); it != keyframes.rend(); ++it) {
+        if (it->turn <= target) {
+            keyframe = &*it;
+            break;
+        }
+    }
+    if (keyframe && target - keyframe->turn < currentTurn - target) {
+        // Any character, and any cell with an item now or then, may change
+        for (const auto& entry : state.items) touchedCells.push_back(entry.first);
+        state = keyframe->state;
+        for (const auto& entry : state.items) touchedCells.push_back(entry.first);
+        std::fill(touchedFields.begin(), touchedFields.end(), ~0u);
+        runTouched = true;
+        for (uint64_t turn = keyframe->turn + 1; turn <= target; ++turn) {
+            flipTurn(turn);
+        }
+    } else {
+        for (uint64_t turn = currentTurn; turn > target; --turn) {
+            flipTurn(turn);
+        }
+    }
+    Restore(player, map, run);
+
+    // The undone turns are forgotten; new turns continue from the target
+    const int undone = static_cast<int>(currentTurn - target);
+    recordCount = turns[(target + 1) % TURN_CAPACITY].firstRecord;
+    currentTurn = target;
+    while (!keyframes.empty() && keyframes.back().turn > target) {
+        keyframes.pop_back();
+    }
+    return undone;
+}
+
+void RewindBuffer::Append(uint32_t target, uint8_t field, uint32_t flips) {
+    records[recordCount % RECORD_CAPACITY] = Record{target << 8 | field, flips};
+    ++recordCount;
+}
+
+void RewindBuffer::Flip(const Record& record) {
+    const uint8_t field = static_cast<uint8_t>(record.key & 0xFF);
+    const uint32_t target = record.key >> 8;
+    if (field == ITEM_CELL) {
+        const auto found = state.items.find(target);
+        const uint8_t id = (found != state.items.end() ? found->second : NO_ITEM) ^ static_cast<uint8_t>(record.flips);
+        if (id == NO_ITEM) {
+            state.items.erase(target);
+        } else {
+            state.items[target] = id;
+        }
+        touchedCells.push_back(target);
+    } else if (field >= RUN_FIELDS) {
+        state.run[field - RUN_FIELDS] ^= record.flips;
+        runTouched = true;
+    } else {
+        state.entities[target][field] ^= record.flips;
+        touchedFields[target] |= 1u << field;
+    }
+}
+
+void RewindBuffer::DropOldest() {
+    ++firstTurn;
+    while (!keyframes.empty() && keyframes.front().turn < firstTurn) {
+        keyframes.pop_front();
+    }
+}
+
+void RewindBuffer::Restore(Character& player, Map& map, SaveGame::Run& run) {
+    static Observable<int> Character::* const STATS[] = {
+        &Character::health, &Character::maxHealth, &Character::attack, &Character::defense,
+        &Character::speed, &Character::avoidance, &Character::level, &Character::experience
+    };  // In EntityField order
+    const uint32_t placement = 1u << POSITION | 1u << FLAGS;
+    auto entity = [&](size_t index) -> Character& { return index == 0 ? player : *map.enemies[index - 1]; };
+
+    // Everyone who moved leaves the grid before anyone is put back, so two
+    // characters can trade cells
+    for (size_t i = 0; i < touchedFields.size(); ++i) {
+        Character& character = entity(i);
+        if ((touchedFields[i] & placement) && map.grid[character.x][character.y] == &character) {
+            map.SetOccupant(character.x, character.y, nullptr);
+            map.changedCells.emplace_back(character.x, character.y);
+        }
+    }
+
+    const std::vector<Item>& catalog = GetItemCatalog();
+    for (size_t i = 0; i < touchedFields.size(); ++i) {
+        const uint32_t fields = touchedFields[i];
+        if (fields == 0) continue;
+        touchedFields[i] = 0;
+        Character& character = entity(i);
+        const EntityState& saved = state.entities[i];
+
+        for (size_t field = HEALTH; field <= EXPERIENCE; ++field) {
+            if (fields & (1u << field)) character.*STATS[field] = static_cast<int>(saved[field]);
+        }
+        if (fields & placement) {
+            character.SetX(static_cast<int>(saved[POSITION] & 0xFFFF));
+            character.SetY(static_cast<int>(saved[POSITION] >> 16));
+            character.SetAbilityUsed((saved[FLAGS] & ABILITY_USED) != 0);
+            if (saved[FLAGS] & ON_MAP) {
+                map.SetOccupant(character.x, character.y, &character);
+                map.changedCells.emplace_back(character.x, character.y);
+            }
+        }
+        if (fields & (1u << INVENTORY | 1u << EQUIPPED)) {
+            character.ToggleInventoryHash(0);
+            character.inventory.clear();
+            for (size_t slot = 0; slot < 4; ++slot) {
+                const uint32_t id = (saved[INVENTORY] >> (8 * slot)) & 0xFF;
+                if (id == 0) break;
+                character.inventory.push_back(std::make_shared<Item>(catalog[id - 1]));
+            }
+            character.ToggleInventoryHash(0);
+            character.SetEquippedWeapon(saved[EQUIPPED] != 0 ? character.inventory[saved[EQUIPPED] - 1] : nullptr);
+            character.statNotifier.Notify(StatBit(StatField::INVENTORY));
+        }
+        for (size_t type = 0; type < EFFECT_COUNT; ++type) {
+            if (!(fields & (3u << (EFFECTS + 2 * type)))) continue;
+            const uint32_t magnitude = saved[EFFECTS + 2 * type];
+            const uint32_t timer = saved[EFFECTS + 2 * type + 1];
+            character.effects.Remove(static_cast<StatusEffectType>(type));
+            if (magnitude & 1) {
+                character.effects.Apply(static_cast<StatusEffectType>(type), static_cast<int>(magnitude >> 1),
+                                        EffectDuration::FromTicks(static_cast<EffectClock>(timer & 1), timer >> 1));
+            }
+        }
+    }
+
+    std::sort(touchedCells.begin(), touchedCells.end());
+    touchedCells.erase(std::unique(touchedCells.begin(), touchedCells.end()), touchedCells.end());
+    for (const uint32_t cell : touchedCells) {
+        const int x = static_cast<int>(cell % mapWidth);
+        const int y = static_cast<int>(cell / mapWidth);
+        const auto found = state.items.find(cell);
+        map.SetItem(x, y, found != state.items.end() ? std::make_shared<Item>(catalog[found->second]) : nullptr);
+        map.changedCells.emplace_back(x, y);
+    }
+    touchedCells.clear();
+
+    if (runTouched) {
+        run.bossRevealed = (state.run[REVEALED] & BOSS_REVEALED) != 0;
+        run.itemsRevealed = (state.run[REVEALED] & ITEMS_REVEALED) != 0;
+        run.monstersRevealed = (state.run[REVEALED] & MONSTERS_REVEALED) != 0;
+        map.rng.Restore(static_cast<uint64_t>(state.run[MAP_RNG_HIGH]) << 32 | state.run[MAP_RNG_LOW],
+                        map.rng.GetIncrement());
+        run.diceRng.Restore(static_cast<uint64_t>(state.run[DICE_RNG_HIGH]) << 32 | state.run[DICE_RNG_LOW],
+                            run.diceRng.GetIncrement());
+        runTouched = false;
+    }
+}
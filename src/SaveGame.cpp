@@ -0,0 +1,383 @@
+#include "SaveGame.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "Tracer.h"
+#include <cstdio>
+#include <cstring>
+
+const char* const SaveGame::DEFAULT_PATH = "fightgpt_save.bin";
+
+namespace {
+constexpr size_t INVENTORY_SLOTS = 4;
+constexpr size_t EFFECT_COUNT = static_cast<size_t>(StatusEffectType::COUNT);
+constexpr uint8_t NO_ITEM = 0xFF;
+constexpr size_t ALIGNMENT = 8;
+
+// Header::flags
+constexpr uint32_t BOSS_REVEALED = 1;
+constexpr uint32_t ITEMS_REVEALED = 2;
+constexpr uint32_t MONSTERS_REVEALED = 4;
+
+// CharacterRecord::flags
+constexpr uint8_t BOSS = 1;
+constexpr uint8_t ABILITY_USED = 2;
+constexpr uint8_t OFF_MAP = 4;  // A defeated enemy, no longer on the grid
+
+struct EffectRecord {
+    int32_t magnitude;
+    uint8_t active;
+    uint8_t clock;       // EffectClock of the expiry
+    uint8_t reserved[2];
+    uint64_t ticksLeft;  // 0 when the effect never expires
+};
+
+struct CharacterRecord {
+    uint32_t nameOffset;  // Into the string section
+    uint32_t nameLength;
+    int32_t health;
+    int32_t maxHealth;
+    int32_t attack;
+    int32_t defense;
+    int32_t speed;
+    int32_t avoidance;
+    int32_t level;
+    int32_t experience;
+    int32_t x;
+    int32_t y;
+    uint8_t flags;
+    uint8_t inventoryCount;
+    uint8_t equippedSlot;  // NO_ITEM when unarmed
+    uint8_t reserved;
+    uint8_t inventory[INVENTORY_SLOTS];  // Item catalog ids
+    EffectRecord effects[EFFECT_COUNT];
+};
+
+struct MapItemRecord {
+    uint16_t x;
+    uint16_t y;
+    uint8_t id;  // Item catalog id
+    uint8_t reserved[3];
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t flags;
+    int32_t characterClass;
+    int32_t mapWidth;
+    int32_t mapHeight;
+    uint32_t enemyCount;
+    uint32_t itemCount;
+    uint32_t wallsOffset;    // mapWidth * mapHeight bits, row-major, in 64-bit words
+    uint32_t enemiesOffset;  // enemyCount CharacterRecords
+    uint32_t itemsOffset;    // itemCount MapItemRecords
+    uint32_t stringsOffset;  // Names, not terminated
+    uint32_t stringsSize;
+    uint64_t mapRngState;
+    uint64_t mapRngIncrement;
+    uint64_t diceRngState;
+    uint64_t diceRngIncrement;
+    CharacterRecord player;
+};
+
+static_assert(sizeof(EffectRecord) == 16, "EffectRecord layout is part of the save format");
+static_assert(sizeof(CharacterRecord) == 136, "CharacterRecord layout is part of the save format");
+static_assert(sizeof(MapItemRecord) == 8, "MapItemRecord layout is part of the save format");
+static_assert(sizeof(Header) == 224, "Header layout is part of the save format");
+static_assert(sizeof(Header) % ALIGNMENT == 0, "Sections after the header must stay aligned");
+
+// Records are written and read as native structs (MSVC targets are always little-endian)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Save files are little-endian; big-endian targets need byte swapping in Write() and Read()"
+#endif
+
+size_t AlignUp(size_t offset) {
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+size_t WallWords(int width, int height) {
+    return (static_cast<size_t>(width) * height + 63) / 64;
+}
+
+// True when count records of the given size fit at offset, which is aligned
+bool SectionFits(uint64_t offset, uint64_t count, uint64_t recordSize, uint64_t fileSize) {
+    return offset % ALIGNMENT == 0 && offset <= fileSize && count <= (fileSize - offset) / recordSize;
+}
+}  // namespace
+
+bool SaveGame::Write(const std::string& path, const Character& player, const Map& map, const Run& run) {
+    TraceScope scope("Write save");
+    static_assert(static_cast<size_t>(Character::MAX_INVENTORY_SIZE) == INVENTORY_SLOTS,
+                  "Inventory records need a slot per item");
+
+    std::string strings;
+    bool valid = true;
+    auto fillCharacter = [&](const Character& character, CharacterRecord& record) {
+        record = CharacterRecord{};
+        record.nameOffset = static_cast<uint32_t>(strings.size());
+        record.nameLength = static_cast<uint32_t>(character.name.size());
+        strings += character.name;
+        record.health = character.health;
+        record.maxHealth = character.maxHealth;
+        record.attack = character.attack;
+        record.defense = character.defense;
+        record.speed = character.speed;
+        record.avoidance = character.avoidance;
+        record.level = character.level;
+        record.experience = character.experience;
+        record.x = character.x;
+        record.y = character.y;
+        record.flags = (character.boss ? BOSS : 0) | (character.abilityUsed ? ABILITY_USED : 0);
+
+        record.inventoryCount = static_cast<uint8_t>(character.inventory.size());
+        record.equippedSlot = NO_ITEM;
+        for (size_t i = 0; i < character.inventory.size(); ++i) {
+            const int id = FindCatalogItem(*character.inventory[i]);
+            if (id < 0) valid = false;
+            record.inventory[i] = static_cast<uint8_t>(id);
+            if (character.inventory[i] == character.equipped_weapon && record.equippedSlot == NO_ITEM) {
+                record.equippedSlot = static_cast<uint8_t>(i);
+            }
+        }
+
+        for (size_t i = 0; i < EFFECT_COUNT; ++i) {
+            const StatusEffectType type = static_cast<StatusEffectType>(i);
+            if (!character.effects.Has(type)) continue;
+            const EffectDuration remaining = character.effects.GetRemainingDuration(type);
+            EffectRecord& effect = record.effects[i];
+            effect.active = 1;
+            effect.magnitude = character.effects.GetMagnitude(type);
+            effect.clock = static_cast<uint8_t>(remaining.GetClock());
+            effect.ticksLeft = remaining.GetTicks();
+        }
+    };
+
+    // Defeated enemies are kept off the grid, so every enemy keeps its index
+    // and the loaded run hashes the same as the saved one
+    std::vector<CharacterRecord> enemies;
+    for (const auto& enemy : map.enemies) {
+        enemies.emplace_back();
+        fillCharacter(*enemy, enemies.back());
+        if (map.grid[enemy->x][enemy->y] != enemy.get()) enemies.back().flags |= OFF_MAP;
+    }
+
+    std::vector<MapItemRecord> items;
+    for (int x = 0; x < map.width; ++x) {
+        for (int y = 0; y < map.height; ++y) {
+            const auto& item = map.item_grid[x][y];
+            if (!item) continue;
+            const int id = FindCatalogItem(*item);
+            if (id < 0) valid = false;
+            items.push_back(MapItemRecord{static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                                          static_cast<uint8_t>(id), {}});
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, "FGSV", 4);
+    header.version = VERSION;
+    header.flags = (run.bossRevealed ? BOSS_REVEALED : 0) | (run.itemsRevealed ? ITEMS_REVEALED : 0) |
+                   (run.monstersRevealed ? MONSTERS_REVEALED : 0);
+    header.characterClass = run.characterClass;
+    header.mapWidth = map.width;
+    header.mapHeight = map.height;
+    header.mapRngState = map.rng.GetState();
+    header.mapRngIncrement = map.rng.GetIncrement();
+    header.diceRngState = run.diceRng.GetState();
+    header.diceRngIncrement = run.diceRng.GetIncrement();
+    fillCharacter(player, header.player);
+    header.enemyCount = static_cast<uint32_t>(enemies.size());
+    header.itemCount = static_cast<uint32_t>(items.size());
+    if (!valid) {
+        Logger::error("Cannot save an item that is not in the item catalog");
+        return false;
+    }
+
+    // Lay the sections out after the header
+    const size_t wallWords = WallWords(map.width, map.height);
+    size_t size = sizeof(Header);
+    header.wallsOffset = static_cast<uint32_t>(size);
+    size += wallWords * sizeof(uint64_t);
+    header.enemiesOffset = static_cast<uint32_t>(size);
+    size += enemies.size() * sizeof(CharacterRecord);
+    header.itemsOffset = static_cast<uint32_t>(size);
+    size = AlignUp(size + items.size() * sizeof(MapItemRecord));
+    header.stringsOffset = static_cast<uint32_t>(size);
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+    size += strings.size();
+    if (size > UINT32_MAX) {
+        Logger::error("Map is too large to save");
+        return false;
+    }
+    header.fileSize = static_cast<uint32_t>(size);
+
+    std::vector<uint8_t> buffer(size, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    uint64_t* walls = reinterpret_cast<uint64_t*>(buffer.data() + header.wallsOffset);
+    for (int x = 0; x < map.width; ++x) {
+        for (int y = 0; y < map.height; ++y) {  // Along the map's own columns
+            if (!map.walls[x][y]) continue;
+            const size_t bit = static_cast<size_t>(y) * map.width + x;
+            walls[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+    }
+    if (!enemies.empty()) {
+        std::memcpy(buffer.data() + header.enemiesOffset, enemies.data(), enemies.size() * sizeof(CharacterRecord));
+    }
+    if (!items.empty()) {
+        std::memcpy(buffer.data() + header.itemsOffset, items.data(), items.size() * sizeof(MapItemRecord));
+    }
+    std::memcpy(buffer.data() + header.stringsOffset, strings.data(), strings.size());
+
+    // Written beside the old save and swapped in, so a failed write loses nothing
+    const std::string temporaryPath = path + ".tmp";
+    FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        Logger::error("Failed to open save file ", temporaryPath);
+        return false;
+    }
+    const bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    if (std::fclose(file) != 0 || !written) {
+        Logger::error("Failed to write save file ", temporaryPath);
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());  // rename() does not replace files on Windows
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        Logger::error("Failed to replace save file ", path);
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SaveGame::Read(const std::string& path, std::unique_ptr<Character>& player, std::unique_ptr<Map>& map,
+                    Run& run) {
+    TraceScope scope("Read save");
+    MappedFile file;
+    if (!file.open(path)) {
+        Logger::error("No save file at ", path);
+        return false;
+    }
+
+    // The mapping is page aligned, so every section can be read in place
+    const size_t size = file.size();
+    const Header* header = reinterpret_cast<const Header*>(file.data());
+    if (size < sizeof(Header) || std::memcmp(header->magic, "FGSV", 4) != 0 || header->version != VERSION ||
+        header->fileSize != size) {
+        Logger::error("Save file is damaged or from another version: ", path);
+        return false;
+    }
+
+    const int width = header->mapWidth;
+    const int height = header->mapHeight;
+    const bool layoutValid =
+        width > 0 && height > 0 && width <= UINT16_MAX && height <= UINT16_MAX &&
+        SectionFits(header->wallsOffset, WallWords(width, height), sizeof(uint64_t), size) &&
+        SectionFits(header->enemiesOffset, header->enemyCount, sizeof(CharacterRecord), size) &&
+        SectionFits(header->itemsOffset, header->itemCount, sizeof(MapItemRecord), size) &&
+        header->stringsOffset <= size && header->stringsSize <= size - header->stringsOffset;
+    if (!layoutValid) {
+        Logger::error("Save file is damaged: ", path);
+        return false;
+    }
+    const uint64_t* walls = reinterpret_cast<const uint64_t*>(file.data() + header->wallsOffset);
+    const CharacterRecord* enemies = reinterpret_cast<const CharacterRecord*>(file.data() + header->enemiesOffset);
+    const MapItemRecord* items = reinterpret_cast<const MapItemRecord*>(file.data() + header->itemsOffset);
+    const char* strings = reinterpret_cast<const char*>(file.data() + header->stringsOffset);
+
+    Pcg32 mapRng;
+    mapRng.Restore(header->mapRngState, header->mapRngIncrement);
+    std::unique_ptr<Map> loadedMap(new Map(width, height, mapRng));
+
+    // Only set bits are visited, so open maps load in a pass over the words
+    const size_t wallWords = WallWords(width, height);
+    for (size_t word = 0; word < wallWords; ++word) {
+        const uint64_t bits = walls[word];
+        if (bits == 0) continue;
+        for (size_t bit = 0; bit < 64; ++bit) {
+            const size_t cell = word * 64 + bit;
+            if (cell >= static_cast<size_t>(width) * height) break;
+            if ((bits >> bit) & 1) {
+                loadedMap->SetWall(static_cast<int>(cell % width), static_cast<int>(cell / width), true);
+            }
+        }
+    }
+
+    // Characters are rebuilt from their records, which are checked against the
+    // map as they go in
+    const std::vector<Item>& catalog = GetItemCatalog();
+    auto buildCharacter = [&](const CharacterRecord& record) -> std::unique_ptr<Character> {
+        const bool recordValid =
+            record.nameOffset <= header->stringsSize && record.nameLength <= header->stringsSize - record.nameOffset &&
+            record.x >= 0 && record.x < width && record.y >= 0 && record.y < height &&
+            ((record.flags & OFF_MAP) ||
+             (!loadedMap->walls[record.x][record.y] && !loadedMap->grid[record.x][record.y])) &&
+            record.inventoryCount <= INVENTORY_SLOTS &&
+            (record.equippedSlot == NO_ITEM || record.equippedSlot < record.inventoryCount);
+        if (!recordValid) return nullptr;
+        for (size_t i = 0; i < record.inventoryCount; ++i) {
+            if (record.inventory[i] >= catalog.size()) return nullptr;
+        }
+        if (record.equippedSlot != NO_ITEM &&
+            catalog[record.inventory[record.equippedSlot]].GetType() != ItemType::WEAPON) {
+            return nullptr;
+        }
+
+        auto character = std::make_unique<Character>(std::string(strings + record.nameOffset, record.nameLength),
+                                                     record.maxHealth, record.attack, record.defense, record.speed,
+                                                     record.avoidance);
+        character->health = record.health;
+        character->level = record.level;
+        character->experience = record.experience;
+        character->SetX(record.x);
+        character->SetY(record.y);
+        character->SetFlags((record.flags & BOSS) != 0, (record.flags & ABILITY_USED) != 0);
+        for (size_t i = 0; i < record.inventoryCount; ++i) {
+            character->AddItem(std::make_shared<Item>(catalog[record.inventory[i]]));
+        }
+        if (record.equippedSlot != NO_ITEM) {
+            character->SetEquippedWeapon(character->inventory[record.equippedSlot]);
+        }
+        for (size_t i = 0; i < EFFECT_COUNT; ++i) {
+            const EffectRecord& effect = record.effects[i];
+            if (!effect.active) continue;
+            const EffectClock clock = effect.clock == static_cast<uint8_t>(EffectClock::SECONDS) ? EffectClock::SECONDS
+                                                                                               : EffectClock::TURNS;
+            character->effects.Apply(static_cast<StatusEffectType>(i), effect.magnitude,
+                                     EffectDuration::FromTicks(clock, effect.ticksLeft));
+        }
+        if (!(record.flags & OFF_MAP)) loadedMap->SetOccupant(record.x, record.y, character.get());
+        return character;
+    };
+
+    std::unique_ptr<Character> loadedPlayer = buildCharacter(header->player);
+    bool valid = loadedPlayer != nullptr && !(header->player.flags & OFF_MAP);
+    for (uint32_t i = 0; valid && i < header->enemyCount; ++i) {
+        std::unique_ptr<Character> enemy = buildCharacter(enemies[i]);
+        valid = enemy != nullptr;
+        if (valid) loadedMap->enemies.push_back(std::move(enemy));
+    }
+    for (uint32_t i = 0; valid && i < header->itemCount; ++i) {
+        const MapItemRecord& record = items[i];
+        valid = record.x < width && record.y < height && record.id < catalog.size() &&
+                !loadedMap->walls[record.x][record.y] && !loadedMap->item_grid[record.x][record.y];
+        if (valid) loadedMap->SetItem(record.x, record.y, std::make_shared<Item>(catalog[record.id]));
+    }
+    if (!valid) {
+        Logger::error("Save file holds an impossible game state: ", path);
+        return false;
+    }
+
+    run.characterClass = header->characterClass;
+    run.bossRevealed = (header->flags & BOSS_REVEALED) != 0;
+    run.itemsRevealed = (header->flags & ITEMS_REVEALED) != 0;
+    run.monstersRevealed = (header->flags & MONSTERS_REVEALED) != 0;
+    run.diceRng.Restore(header->diceRngState, header->diceRngIncrement);
+    player = std::move(loadedPlayer);
+    map = std::move(loadedMap);
+    return true;
+}
@@ -0,0 +1,36 @@
+#include "SpriteBatch.h"
+
+void SpriteBatch::addQuad(const sf::FloatRect& bounds, const sf::FloatRect& textureRect, const sf::Color& color) {
+    const float left = bounds.left;
+    const float top = bounds.top;
+    const float right = bounds.left + bounds.width;
+    const float bottom = bounds.top + bounds.height;
+    const float u0 = textureRect.left;
+    const float v0 = textureRect.top;
+    const float u1 = textureRect.left + textureRect.width;
+    const float v1 = textureRect.top + textureRect.height;
+
+    // Two triangles per quad
+    vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)));
+    vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+    vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+    vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+    vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+    vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)));
+}
+
+void SpriteBatch::addText(const TextLayout& layout, const sf::Vector2f& position, const sf::Color& color) {
+    for (const GlyphQuad& glyph : layout) {
+        addQuad(sf::FloatRect(position.x + glyph.bounds.left, position.y + glyph.bounds.top,
+                              glyph.bounds.width, glyph.bounds.height),
+                glyph.textureRect, color);
+    }
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, RenderStats& stats, sf::RenderStates states) const {
+    if (vertices.getVertexCount() == 0) return;
+    states.texture = texture;
+    target.draw(vertices, states);
+    ++stats.drawCalls;
+    stats.quads += static_cast<unsigned>(getQuadCount());
+}
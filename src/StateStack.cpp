@@ -0,0 +1,65 @@
+#include "StateStack.h"
+#include "Logger.h"
+#include "Tracer.h"
+
+void StateStack::push(std::unique_ptr<GameState> state) {
+    if (!states.empty()) {
+        states.back()->onPause();
+    }
+    states.push_back(std::move(state));
+    states.back()->onEnter();
+    states.back()->requestRedraw();
+}
+
+void StateStack::pop(size_t count) {
+    // The bottom state stays; there is nothing to show without it
+    if (count >= states.size()) {
+        Logger::error("Cannot pop ", count, " of ", states.size(), " game states");
+        count = states.size() - 1;
+    }
+    if (count == 0) return;
+
+    std::unique_ptr<GameState> popped;
+    for (size_t i = 0; i < count; ++i) {
+        popped = std::move(states.back());
+        states.pop_back();
+        popped->onExit();
+    }
+    states.back()->onResume(std::move(popped));
+    states.back()->requestRedraw();
+}
+
+bool StateStack::applyTransition() {
+    if (states.empty() || !states.back()->hasTransition()) return false;
+    TraceScope scope("State transition");
+
+    GameState::Transition transition = states.back()->takeTransition();
+    switch (transition.kind) {
+        case GameState::Transition::Kind::PUSH:
+            push(std::move(transition.state));
+            break;
+        case GameState::Transition::Kind::REPLACE:
+            states.back()->onExit();
+            states.back() = std::move(transition.state);
+            states.back()->onEnter();
+            states.back()->requestRedraw();
+            break;
+        case GameState::Transition::Kind::POP:
+            pop(transition.popCount);
+            break;
+        case GameState::Transition::Kind::NONE:
+            return false;
+    }
+    return true;
+}
+
+void StateStack::draw(sf::RenderWindow& window) {
+    size_t bottom = states.size() - 1;
+    while (bottom > 0 && states[bottom]->isOverlay()) {
+        --bottom;
+    }
+    for (size_t i = bottom; i < states.size(); ++i) {
+        states[i]->draw(window);
+    }
+    states.back()->clearRedraw();
+}
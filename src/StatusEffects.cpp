@@ -0,0 +1,245 @@
+#include "StatusEffects.h"
+#include "GameLogic.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void BleedTick(Character& owner, const StatusEffect& effect) {
+    owner.TakeEffectDamage(effect.magnitude);
+}
+
+void BurnTick(Character& owner, const StatusEffect& effect) {
+    owner.TakeEffectDamage(effect.magnitude);
+}
+
+// Adding an effect type means adding its enum value and one row here
+const StatusEffectDefinition DEFINITIONS[] = {
+    // name             stacking                      max  tick clock           interval  callback
+    {"Wounded",         StackingRule::KEEP_EXISTING,  5,   EffectClock::TURNS,  1,        BleedTick},
+    {"Burn",            StackingRule::KEEP_EXISTING,  5,   EffectClock::TURNS,  1,        BurnTick},
+    {"Rage",            StackingRule::KEEP_EXISTING,  1,   EffectClock::TURNS,  0,        nullptr},
+    {"Hunter's Mark",   StackingRule::REFRESH,        3,   EffectClock::TURNS,  0,        nullptr},
+    {"Strength",        StackingRule::REFRESH,        100, EffectClock::SECONDS, 0,       nullptr},
+};
+
+static_assert(sizeof(DEFINITIONS) / sizeof(DEFINITIONS[0]) == static_cast<size_t>(StatusEffectType::COUNT),
+              "Every StatusEffectType needs a definition");
+
+}  // namespace
+
+const StatusEffectDefinition& GetStatusEffectDefinition(StatusEffectType type) {
+    return DEFINITIONS[static_cast<size_t>(type)];
+}
+
+EffectDuration EffectDuration::Seconds(float seconds) {
+    uint64_t ticks = static_cast<uint64_t>(std::ceil(seconds / StatusEffectScheduler::SECONDS_PER_TICK));
+    return EffectDuration(EffectClock::SECONDS, std::max<uint64_t>(1, ticks));
+}
+
+TimingWheel::TimingWheel() : now(0), scheduledCount(0) {
+    for (auto& level : slots) {
+        for (auto& head : level) {
+            head.next = head.prev = &head;
+        }
+    }
+}
+
+void TimingWheel::Schedule(Timer& timer, uint64_t delay) {
+    Cancel(timer);
+    timer.deadline = now + std::max<uint64_t>(1, delay);
+    Insert(timer);
+}
+
+void TimingWheel::Cancel(Timer& timer) {
+    if (timer.IsScheduled()) {
+        Unlink(timer);
+    }
+}
+
+void TimingWheel::Insert(Timer& timer) {
+    uint64_t delta = timer.deadline - now;
+    for (int level = 0; level < LEVELS; ++level) {
+        uint64_t range = uint64_t(1) << (SLOT_BITS * (level + 1));
+        if (delta < range || level == LEVELS - 1) {
+            // Deadlines beyond the top level are parked in its furthest slot and re-inserted when due
+            uint64_t target = delta < range ? timer.deadline : now + range - 1;
+            Link(slots[level][(target >> (SLOT_BITS * level)) & (SLOTS - 1)], timer);
+            return;
+        }
+    }
+}
+
+void TimingWheel::Cascade(int level) {
+    Timer& head = slots[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    while (head.next != &head) {
+        Timer& timer = *head.next;
+        Unlink(timer);
+        Insert(timer);
+    }
+}
+
+void TimingWheel::Link(Timer& head, Timer& timer) {
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+    ++scheduledCount;
+}
+
+void TimingWheel::Unlink(Timer& timer) {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = timer.next = nullptr;
+    --scheduledCount;
+}
+
+StatusEffectScheduler& StatusEffectScheduler::Instance() {
+    static StatusEffectScheduler scheduler;
+    return scheduler;
+}
+
+void StatusEffectScheduler::AdvanceTurn() {
+    turnWheel.Advance(1, OnTimer);
+}
+
+void StatusEffectScheduler::AdvanceTime(float deltaTime) {
+    pendingSeconds += deltaTime;
+    uint64_t ticks = static_cast<uint64_t>(pendingSeconds / SECONDS_PER_TICK);
+    if (ticks > 0) {
+        pendingSeconds -= ticks * SECONDS_PER_TICK;
+        timeWheel.Advance(ticks, OnTimer);
+    }
+}
+
+void StatusEffectScheduler::OnTimer(TimingWheel::Timer& timer) {
+    auto& effectTimer = static_cast<EffectList::EffectTimer&>(timer);
+    effectTimer.list->onTimer(effectTimer);
+}
+
+void EffectList::Apply(StatusEffectType type, int magnitude, EffectDuration duration) {
+    const StatusEffectDefinition& definition = GetStatusEffectDefinition(type);
+    Slot& s = slot(type);
+    const StatusEffect before = s.effect;
+
+    if (s.effect.active) {
+        switch (definition.stacking) {
+            case StackingRule::KEEP_EXISTING:
+                return;
+            case StackingRule::REFRESH:
+                s.effect.magnitude = magnitude;
+                break;
+            case StackingRule::STACK:
+                s.effect.magnitude += magnitude;
+                break;
+        }
+    } else {
+        s.effect.active = true;
+        s.effect.magnitude = magnitude;
+        if (definition.tickInterval > 0) {
+            schedule(s.tick, type, definition.tickClock, definition.tickInterval, true);
+        }
+    }
+    s.effect.magnitude = std::min(s.effect.magnitude, definition.maxMagnitude);
+
+    if (duration.GetTicks() > 0) {
+        schedule(s.expiry, type, duration.GetClock(), duration.GetTicks(), false);
+    } else {
+        cancel(s.expiry);
+    }
+    rehash(type, before);
+    owner.GetStatNotifier().Notify(StatBit(StatField::EFFECTS));
+}
+
+void EffectList::Remove(StatusEffectType type) {
+    Slot& s = slot(type);
+    cancel(s.expiry);
+    cancel(s.tick);
+    if (!s.effect.active) return;
+    const StatusEffect before = s.effect;
+    s.effect = StatusEffect();
+    rehash(type, before);
+    owner.GetStatNotifier().Notify(StatBit(StatField::EFFECTS));
+}
+
+void EffectList::Clear() {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Remove(static_cast<StatusEffectType>(i));
+    }
+}
+
+int EffectList::GetMagnitude(StatusEffectType type) const {
+    const Slot& s = slot(type);
+    return s.effect.active ? s.effect.magnitude : 0;
+}
+
+void EffectList::ConsumeMagnitude(StatusEffectType type, int amount) {
+    Slot& s = slot(type);
+    if (!s.effect.active) return;
+    if (s.effect.magnitude <= amount) {
+        Remove(type);
+        return;
+    }
+    const StatusEffect before = s.effect;
+    s.effect.magnitude -= amount;
+    rehash(type, before);
+    owner.GetStatNotifier().Notify(StatBit(StatField::EFFECTS));
+}
+
+float EffectList::GetRemainingSeconds(StatusEffectType type) const {
+    const EffectTimer& expiry = slot(type).expiry;
+    if (!expiry.IsScheduled() || expiry.clock != EffectClock::SECONDS) return 0.0f;
+    StatusEffectScheduler& scheduler = StatusEffectScheduler::Instance();
+    uint64_t ticksLeft = expiry.deadline - scheduler.GetWheel(EffectClock::SECONDS).Now();
+    return std::max(0.0f, ticksLeft * StatusEffectScheduler::SECONDS_PER_TICK - scheduler.GetPendingSeconds());
+}
+
+int EffectList::GetRemainingTurns(StatusEffectType type) const {
+    const EffectTimer& expiry = slot(type).expiry;
+    if (!expiry.IsScheduled() || expiry.clock != EffectClock::TURNS) return 0;
+    return static_cast<int>(expiry.deadline - StatusEffectScheduler::Instance().GetWheel(EffectClock::TURNS).Now());
+}
+
+EffectDuration EffectList::GetRemainingDuration(StatusEffectType type) const {
+    const EffectTimer& expiry = slot(type).expiry;
+    if (!expiry.IsScheduled()) return EffectDuration::Permanent();
+    const uint64_t now = StatusEffectScheduler::Instance().GetWheel(expiry.clock).Now();
+    return EffectDuration::FromTicks(expiry.clock, std::max<uint64_t>(1, expiry.deadline - now));
+}
+
+void EffectList::schedule(EffectTimer& timer, StatusEffectType type, EffectClock clock, uint64_t delay, bool isTick) {
+    cancel(timer);
+    timer.list = this;
+    timer.type = type;
+    timer.isTick = isTick;
+    timer.clock = clock;
+    StatusEffectScheduler::Instance().GetWheel(clock).Schedule(timer, delay);
+}
+
+void EffectList::cancel(EffectTimer& timer) {
+    if (timer.IsScheduled()) {
+        StatusEffectScheduler::Instance().GetWheel(timer.clock).Cancel(timer);
+    }
+}
+
+void EffectList::onTimer(EffectTimer& timer) {
+    Slot& s = slot(timer.type);
+    if (!timer.isTick) {
+        Remove(timer.type);
+        return;
+    }
+
+    const StatusEffectDefinition& definition = GetStatusEffectDefinition(timer.type);
+    schedule(s.tick, timer.type, definition.tickClock, definition.tickInterval, true);
+    definition.onTick(owner, s.effect);
+}
+
+void EffectList::rehash(StatusEffectType type, const StatusEffect& before) {
+    // Remaining durations are left out: they shrink every tick, and the wheels'
+    // clocks carry on from one run to the next
+    auto value = [](const StatusEffect& effect) -> int64_t {
+        return effect.active ? static_cast<int64_t>(effect.magnitude) << 1 | 1 : 0;
+    };
+    owner.stateHash.Change(Character::HASH_EFFECTS + static_cast<uint32_t>(type), value(before),
+                           value(slot(type).effect));
+}
@@ -1,6 +1,9 @@
 #include "StoryState.h"
 #include "GamePlayState.h"
+#include "AssetCache.h"
 #include "Logger.h"
+#include "TextWrapper.h"
+#include "Tracer.h"
 #include <sstream>
 
 StoryState::StoryState(int selectedCharacter, const std::string& playerName, const std::string& bossName)
@@ -11,10 +14,7 @@ StoryState::StoryState(int selectedCharacter, const std::string& playerName, con
       pulseEffect(0.0f),
       continueTextDelay(0.0f) {
     
-    if (!font.loadFromFile("assets/fonts/Jersey15-Regular.ttf")) {
-        Logger::error("Failed to load font!");
-        return;
-    }
+    font = AssetCache::Instance().getFont(AssetCache::DEFAULT_FONT_PATH);
 
     // Create dark overlay background
     background.setSize(sf::Vector2f(1200, 800));  // Window size
@@ -23,7 +23,7 @@ StoryState::StoryState(int selectedCharacter, const std::string& playerName, con
     // Set up story text with padding
     const float horizontalPadding = 40.0f;  // Reduced padding
     const float verticalPadding = 40.0f;    // Reduced padding
-    storyText.setFont(font);
+    storyText.setFont(*font);
     storyText.setCharacterSize(18);         // Even smaller font size
     storyText.setFillColor(sf::Color(255, 255, 255, 0));  // Start fully transparent
     storyText.setLineSpacing(1.3f);  // Slightly reduced line spacing
@@ -52,7 +52,7 @@ StoryState::StoryState(int selectedCharacter, const std::string& playerName, con
     storyText.setPosition(1200 / 2.0f, 800 / 2.0f);
 
     // Set up the continue text
-    continueText.setFont(font);
+    continueText.setFont(*font);
     continueText.setString("Press ENTER to begin your quest...");
     continueText.setCharacterSize(20);  // Smaller continue text
     continueText.setFillColor(sf::Color(255, 255, 255, 0));  // Start invisible
@@ -103,73 +103,27 @@ void StoryState::generateStory() {
 void StoryState::formatText() {
     // Set a fixed width for the text, accounting for padding
     const float maxWidth = 420.0f;  // Further reduced width of the text block
-    
+
     std::string originalText = storyText.getString();
-    std::string formattedText;
-    std::string currentLine;
-    std::istringstream words(originalText);
-    std::string word;
-    
-    float currentLineWidth = 0.0f;
-    
-    // Create a temporary text object for width measurements
-    sf::Text tempText;
-    tempText.setFont(font);
-    tempText.setCharacterSize(18);  // Match the story text size
-    
-    while (std::getline(words, word, ' ')) {
-        // Handle newlines in the original text
-        size_t newlinePos = word.find("\\n");
-        if (newlinePos != std::string::npos) {
-            if (newlinePos == 0) {
-                formattedText += "\n";
-            } else {
-                formattedText += currentLine + word.substr(0, newlinePos) + "\n";
-                currentLine = "";
-            }
-            currentLineWidth = 0.0f;
-            continue;
-        }
-        
-        // Measure this word
-        tempText.setString(word + " ");
-        float wordWidth = tempText.getLocalBounds().width;
-        
-        if (currentLineWidth + wordWidth > maxWidth) {
-            // Line would be too long, add a newline
-            formattedText += currentLine + "\n";
-            currentLine = word + " ";
-            currentLineWidth = wordWidth;
-        } else {
-            // Add to current line
-            currentLine += word + " ";
-            currentLineWidth += wordWidth;
-        }
-    }
-    
-    // Add the last line
-    formattedText += currentLine;
-    
-    // Set the formatted text
-    storyText.setString(formattedText);
+    TextWrapper wrapper(*font, storyText.getCharacterSize());
+    storyText.setString(wrapper.wrapToString(originalText, maxWidth));
 }
 
 void StoryState::handleEvent(const sf::Event& event, sf::RenderWindow& /*window*/) {
     if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Return) {
-        nextState = std::make_unique<GamePlayState>(selectedCharacter, playerName, bossName);
+        TraceScope scope("Create gameplay state");
+        replaceState(std::make_unique<GamePlayState>(selectedCharacter, playerName, bossName));
     }
 }
 
 void StoryState::update(float deltaTime) {
+    previousFadeIn = textFadeIn;
+    previousPulse = pulseEffect;
+
     // Fade in text gradually
     if (textFadeIn < 1.0f) {
         textFadeIn += deltaTime * 2.0f; // Adjust speed by changing multiplier
         if (textFadeIn > 1.0f) textFadeIn = 1.0f;
-
-        // Update story text opacity
-        sf::Color storyColor = storyText.getFillColor();
-        storyColor.a = static_cast<sf::Uint8>(255 * textFadeIn);
-        storyText.setFillColor(storyColor);
     }
 
     // Handle continue text delay and effects
@@ -177,24 +131,34 @@ void StoryState::update(float deltaTime) {
         continueTextDelay += deltaTime;
         
         if (continueTextDelay >= 5.0f) {  // After 5 seconds
-            // Start pulsing the continue text
             pulseEffect += deltaTime * 3.0f;  // Control pulse speed
-            float alpha = (std::sin(pulseEffect) + 1.0f) / 2.0f;  // Oscillate between 0 and 1
-            
-            // Apply pulse effect to continue text
-            sf::Color textColor = continueText.getFillColor();
-            textColor.a = static_cast<sf::Uint8>(155 + 100 * alpha);  // Pulse between 155 and 255 alpha
-            continueText.setFillColor(textColor);
-        } else {
-            // Keep continue text invisible until delay is over
-            continueText.setFillColor(sf::Color(255, 255, 255, 0));
         }
     }
 }
 
 void StoryState::draw(sf::RenderWindow& window) {
+    // Update story text opacity
+    const float fade = previousFadeIn + (textFadeIn - previousFadeIn) * interpolation;
+    sf::Color storyColor = storyText.getFillColor();
+    storyColor.a = static_cast<sf::Uint8>(255 * fade);
+    storyText.setFillColor(storyColor);
+
+    if (continueTextDelay >= 5.0f) {
+        // Pulse the continue text
+        const float pulse = previousPulse + (pulseEffect - previousPulse) * interpolation;
+        float alpha = (std::sin(pulse) + 1.0f) / 2.0f;  // Oscillate between 0 and 1
+
+        // Apply pulse effect to continue text
+        sf::Color textColor = continueText.getFillColor();
+        textColor.a = static_cast<sf::Uint8>(155 + 100 * alpha);  // Pulse between 155 and 255 alpha
+        continueText.setFillColor(textColor);
+    } else {
+        // Keep continue text invisible until delay is over
+        continueText.setFillColor(sf::Color(255, 255, 255, 0));
+    }
+
     window.draw(background);
     window.draw(textBackground);
     window.draw(storyText);
     window.draw(continueText);
-} 
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+#include "TextCache.h"
+
+sf::Text& TextCache::get(const sf::Font& font, unsigned characterSize, std::string_view string) {
+    Entry& entry = find(font, characterSize, string);
+    if (!entry.hasText) {
+        entry.text.setFont(font);
+        entry.text.setCharacterSize(characterSize);
+        entry.text.setString(std::string(string));
+        entry.hasText = true;
+    }
+    return entry.text;
+}
+
+const TextLayout& TextCache::layout(const sf::Font& font, unsigned characterSize, std::string_view string) {
+    Entry& entry = find(font, characterSize, string);
+    if (entry.hasGlyphs) return entry.glyphs;
+
+    // Same placement as sf::Text: glyphs hang from a baseline one character size down
+    float x = 0.0f;
+    const float baseline = static_cast<float>(characterSize);
+    sf::Uint32 previous = 0;
+    for (unsigned char c : string) {
+        sf::Uint32 current = c;
+        x += font.getKerning(previous, current, characterSize);
+        previous = current;
+
+        const sf::Glyph& glyph = font.getGlyph(current, characterSize, false);
+        if (glyph.textureRect.width > 0 && glyph.textureRect.height > 0) {
+            entry.glyphs.push_back({sf::FloatRect(x + glyph.bounds.left, baseline + glyph.bounds.top,
+                                                  glyph.bounds.width, glyph.bounds.height),
+                                    sf::FloatRect(glyph.textureRect)});
+        }
+        x += glyph.advance;
+    }
+    entry.hasGlyphs = true;
+    return entry.glyphs;
+}
+
+TextCache::Entry& TextCache::find(const sf::Font& font, unsigned characterSize, std::string_view string) {
+    auto it = entries.find(KeyView{&font, characterSize, string});
+    if (it == entries.end()) {
+        if (entries.size() >= MAX_ENTRIES) {
+            evictStale();
+        }
+        it = entries.emplace(Key{&font, characterSize, std::string(string)}, Entry()).first;
+    }
+    it->second.lastUsed = frame;
+    return it->second;
+}
+
+void TextCache::evictStale() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.lastUsed + EVICT_AFTER_FRAMES < frame) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
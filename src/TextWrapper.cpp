@@ -0,0 +1,86 @@
+#include "TextWrapper.h"
+
+void TextWrapper::setFont(const sf::Font& wrapFont, unsigned wrapCharacterSize) {
+    font = &wrapFont;
+    characterSize = wrapCharacterSize;
+    hasAdvance.fill(false);
+    kernings.clear();
+}
+
+float TextWrapper::advance(unsigned char c) {
+    if (!hasAdvance[c]) {
+        advances[c] = font->getGlyph(c, characterSize, false).advance;
+        hasAdvance[c] = true;
+    }
+    return advances[c];
+}
+
+float TextWrapper::kerning(unsigned char first, unsigned char second) {
+    const unsigned key = static_cast<unsigned>(first) << 8 | second;
+    auto it = kernings.find(key);
+    if (it == kernings.end()) {
+        it = kernings.emplace(key, font->getKerning(first, second, characterSize)).first;
+    }
+    return it->second;
+}
+
+void TextWrapper::wrap(std::string_view text, float maxWidth, std::vector<std::string_view>& lines) {
+    const size_t NONE = std::string_view::npos;
+    size_t lineStart = 0;
+    size_t lastSpace = NONE;     // Last space on the current line, where it can break
+    float widthToSpace = 0.0f;   // Line width up to and including that space
+    float x = 0.0f;
+    unsigned char previous = 0;
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\n') {
+            lines.push_back(text.substr(lineStart, i - lineStart));
+            lineStart = i + 1;
+            lastSpace = NONE;
+            x = 0.0f;
+            previous = 0;
+            continue;
+        }
+
+        if (!font) continue;  // Nothing to measure with; breaks at newlines only
+
+        x += kerning(previous, c) + advance(c);
+        previous = c;
+        if (c == ' ') {
+            lastSpace = i;
+            widthToSpace = x;
+            continue;  // Trailing spaces never push a line over
+        }
+        if (x <= maxWidth || i == lineStart) continue;
+
+        if (lastSpace != NONE) {
+            // Move the word being typed to the next line
+            size_t end = lastSpace;
+            while (end > lineStart && text[end - 1] == ' ') --end;
+            lines.push_back(text.substr(lineStart, end - lineStart));
+            lineStart = lastSpace + 1;
+            x -= widthToSpace;
+        } else {
+            // No space to break at; split the word before this character
+            lines.push_back(text.substr(lineStart, i - lineStart));
+            lineStart = i;
+            x = advance(c);
+        }
+        lastSpace = NONE;
+    }
+    lines.push_back(text.substr(lineStart));
+}
+
+std::string TextWrapper::wrapToString(std::string_view text, float maxWidth) {
+    scratch.clear();
+    wrap(text, maxWidth, scratch);
+
+    std::string wrapped;
+    wrapped.reserve(text.size());
+    for (size_t i = 0; i < scratch.size(); ++i) {
+        if (i > 0) wrapped += '\n';
+        wrapped += scratch[i];
+    }
+    return wrapped;
+}
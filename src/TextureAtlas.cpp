@@ -0,0 +1,51 @@
+#include "TextureAtlas.h"
+#include "AssetCache.h"
+#include "Logger.h"
+#include "Tracer.h"
+
+TextureAtlas& TextureAtlas::Instance() {
+    // Never destroyed so the texture outlives every state and the window
+    static TextureAtlas* atlas = new TextureAtlas();
+    return *atlas;
+}
+
+bool TextureAtlas::load() {
+    if (loaded) return true;
+    TraceScope scope("Load texture atlas");
+
+    texture = AssetCache::Instance().getTexture(SpriteAtlas::PAGE_PATH);
+    if (texture->getSize() == sf::Vector2u(0, 0)) {
+        return false;  // Already reported by the cache
+    }
+    if (texture->getSize() != sf::Vector2u(SpriteAtlas::PAGE_WIDTH, SpriteAtlas::PAGE_HEIGHT)) {
+        Logger::error("Sprite atlas does not match SpriteAtlas.h, rerun bake_atlas.py");
+        return false;
+    }
+    loaded = true;
+    return true;
+}
+
+void TextureAtlas::preload() {
+    if (!loaded) AssetCache::Instance().preloadTexture(SpriteAtlas::PAGE_PATH);
+}
+
+bool TextureAtlas::isReady() const {
+    return loaded || AssetCache::Instance().isTextureReady(SpriteAtlas::PAGE_PATH);
+}
+
+sf::FloatRect TextureAtlas::getRegion(SpriteAtlas::Sprite sprite) const {
+    const SpriteAtlas::Rect& rect = SpriteAtlas::GetRect(sprite);
+    return sf::FloatRect(static_cast<float>(rect.left), static_cast<float>(rect.top),
+                         static_cast<float>(rect.width), static_cast<float>(rect.height));
+}
+
+sf::FloatRect TextureAtlas::getSolidRegion() const {
+    const SpriteAtlas::Rect& rect = SpriteAtlas::GetRect(SpriteAtlas::Sprite::SOLID);
+    return sf::FloatRect(rect.left + 1.0f, rect.top + 1.0f, 1.0f, 1.0f);
+}
+
+void TextureAtlas::apply(sf::Sprite& sprite, SpriteAtlas::Sprite region) const {
+    const SpriteAtlas::Rect& rect = SpriteAtlas::GetRect(region);
+    sprite.setTexture(*texture);
+    sprite.setTextureRect(sf::IntRect(rect.left, rect.top, rect.width, rect.height));
+}
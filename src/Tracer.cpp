@@ -0,0 +1,127 @@
+#include "Tracer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+const char* const Tracer::DEFAULT_PATH = "fightgpt_trace.json";
+
+Tracer& Tracer::Instance() {
+    // Never destroyed so threads can still record during shutdown
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+int64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* Tracer::configuredPath() {
+    const char* path = std::getenv("FIGHTGPT_TRACE");
+    return path && *path ? path : nullptr;
+}
+
+void Tracer::start() {
+    if (isCapturing()) return;
+
+    if (!events) {
+        events = std::make_unique<Event[]>(CAPACITY);
+    }
+
+    // Scopes that passed the capturing check just before the last stop() may
+    // still claim or fill slots. Marking the buffer full turns new claims away
+    // while the claimed slots are finished and cleared, so no slot gets two writers.
+    const size_t previous = std::min(claimed.exchange(CAPACITY, std::memory_order_acq_rel), CAPACITY);
+    for (size_t i = 0; i < previous; ++i) {
+        while (!events[i].ready.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        events[i].ready.store(false, std::memory_order_relaxed);
+    }
+    origin = now();
+    epoch.fetch_add(1, std::memory_order_release);
+    claimed.store(0, std::memory_order_release);
+    capturing.store(true, std::memory_order_release);
+    Logger::info("Trace capture started");
+}
+
+void Tracer::record(const char* name, int64_t beginNanoseconds, int64_t endNanoseconds) {
+    // Read before the capturing check, so a scope that straddles a restart keeps the old epoch
+    const uint32_t captureEpoch = epoch.load(std::memory_order_acquire);
+    if (!capturing.load(std::memory_order_acquire)) return;
+
+    const size_t index = claimed.fetch_add(1, std::memory_order_relaxed);
+    if (index >= CAPACITY) return;  // Full; counted when the capture is written
+
+    Event& event = events[index];
+    event.name = name;
+    event.begin = beginNanoseconds;
+    event.end = endNanoseconds;
+    event.thread = Logger::threadId();
+    event.epoch = captureEpoch;
+    event.ready.store(true, std::memory_order_release);
+}
+
+void Tracer::nameThread(const char* name) {
+    const uint32_t thread = Logger::threadId();
+    if (thread < MAX_THREADS) {
+        threadNames[thread].store(name, std::memory_order_relaxed);
+    }
+}
+
+bool Tracer::stop(const std::string& path) {
+    if (!isCapturing()) return false;
+    capturing.store(false, std::memory_order_relaxed);
+
+    // Scopes that claimed a slot before the stop may still be filling it in
+    const size_t total = claimed.load(std::memory_order_relaxed);
+    const size_t count = std::min(total, CAPACITY);
+    for (size_t i = 0; i < count; ++i) {
+        while (!events[i].ready.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        Logger::error("Failed to open trace file ", path);
+        return false;
+    }
+
+    // Complete ("X") events in microseconds since the capture started
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (size_t thread = 0; thread < MAX_THREADS; ++thread) {
+        const char* name = threadNames[thread].load(std::memory_order_relaxed);
+        if (!name) continue;
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", thread, name);
+        first = false;
+    }
+    const uint32_t currentEpoch = epoch.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        // A scope from the previous capture that claimed its slot after this one started
+        const Event& event = events[i];
+        if (event.epoch != currentEpoch) continue;
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"fightgpt\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                           "\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",\n", event.name, event.thread, (event.begin - origin) / 1000.0,
+                     (event.end - event.begin) / 1000.0);
+        first = false;
+    }
+    std::fputs("\n]}\n", file);
+    const bool written = std::fclose(file) == 0;
+
+    if (total > CAPACITY) {
+        Logger::error("Trace buffer full, dropped ", total - CAPACITY, " events");
+    }
+    if (!written) {
+        Logger::error("Failed to write trace file ", path);
+        return false;
+    }
+    Logger::info("Wrote ", count, " trace events to ", path);
+    return true;
+}
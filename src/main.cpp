@@ -2,58 +2,161 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include "AssetCache.h"
 #include "GameState.h"
+#include "StateStack.h"
 #include "NameInputState.h"
 #include "CharacterSelectionState.h"
 #include "GamePlayState.h"
 #include "Logger.h"
+#include "AllocationCounter.h"
+#include "FixedTimestep.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "Tracer.h"
 
 int main() {
     Logger::info("Starting FightGPT");
+    sf::Clock startupClock;  // Until the first frame with every startup asset on screen
+    bool startupReported = false;
+
+    // FIGHTGPT_TRACE=<file> captures a trace of the whole session
+    Tracer& tracer = Tracer::Instance();
+    tracer.nameThread("Main");
+    const char* tracePath = Tracer::configuredPath();
+    if (tracePath) {
+        tracer.start();
+    }
     
     // Create the main window with larger size
     sf::RenderWindow window(sf::VideoMode(1200, 800), "FightGPT");
     window.setVerticalSyncEnabled(true);
 
-    // Create the game state manager starting with name input
-    std::unique_ptr<GameState> currentState = std::make_unique<NameInputState>();
+    // Screens stack up from name input; menus stay below the game, ready to return to
+    StateStack states;
+    states.push(std::make_unique<NameInputState>());
     sf::Clock clock;
+    FixedTimestep timestep;
+    uint64_t reportedFrameAllocations = UINT64_MAX;
+
+    // F3 shows frame timings; nothing is recorded while it is hidden
+    ProfilerOverlay profilerOverlay;
+    sf::Clock overlayClock;
+
+    auto handleEvent = [&](const sf::Event& event) {
+        if (event.type == sf::Event::Closed) {
+            Logger::info("Window closed by user");
+            window.close();
+        } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+            Logger::info("Game exited via ESC key");
+            window.close();
+        } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+            profilerOverlay.toggle();
+            states.top().requestRedraw();
+        } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4) {
+            // F4 starts a trace capture and writes it on the next press
+            if (tracer.isCapturing()) {
+                tracer.stop(tracePath ? tracePath : Tracer::DEFAULT_PATH);
+            } else {
+                tracer.start();
+            }
+        } else {
+            // Handle state-specific events; any input may change what is shown
+            states.top().handleEvent(event, window);
+            states.top().requestRedraw();
+        }
+    };
+
+    // Swaps in the state the top one asked for; the new top state starts on a fresh step
+    auto applyTransition = [&]() {
+        if (!states.applyTransition()) return false;
+        Logger::info("Transitioning to new game state");
+        AssetCache::Instance().releaseUnused();  // Every state left holds what it shares
+        timestep.reset();
+        return true;
+    };
 
     // Main game loop
     while (window.isOpen()) {
         sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                Logger::info("Window closed by user");
-                window.close();
-            } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-                Logger::info("Game exited via ESC key");
-                window.close();
-            } else {
-                // Handle state-specific events
-                currentState->handleEvent(event, window);
+
+        // Nothing on screen can change until the next event, so sleep until it
+        // arrives; nothing animated meanwhile, so the wait is not simulated
+        // The profiler graph moves every frame while it is shown
+        if (!states.top().needsRedraw() && !profilerOverlay.isVisible() && window.waitEvent(event)) {
+            handleEvent(event);
+            clock.restart();
+            timestep.reset();
+        }
+
+        ProfileScope frameScope(ProfilePhase::FRAME);
+        {
+            ProfileScope scope(ProfilePhase::EVENTS);
+            while (window.pollEvent(event)) {
+                handleEvent(event);
             }
         }
+        if (!window.isOpen()) break;
         
-        float deltaTime = clock.restart().asSeconds();
-        currentState->update(deltaTime);
+        const uint64_t allocationsBefore = AllocationCounter::GetCount();
+
+        // Advance in fixed steps, however long the frame took
+        {
+            ProfileScope scope(ProfilePhase::UPDATE);
+            AssetCache::Instance().update();
 
-        // Check for state transition
-        if (auto nextState = currentState->getNextState()) {
-            Logger::info("Transitioning to new game state");
-            currentState = std::move(nextState);
+            // Input can ask for a new state on a frame with no step due, right
+            // after a wake from waitEvent() for one; it must not wait for a step
+            applyTransition();
+
+            const int steps = timestep.advance(clock.restart().asSeconds());
+            for (int step = 0; step < steps; ++step) {
+                states.top().update(timestep.getStep());
+
+                if (applyTransition()) break;
+            }
+            states.top().setInterpolation(timestep.getAlpha());
+            profilerOverlay.update(overlayClock.restart().asSeconds());
         }
         
-        // Clear the window with dark background
-        window.clear(sf::Color(20, 20, 20));
+        if (!states.top().needsRedraw() && !profilerOverlay.isVisible()) continue;
 
-        // Draw the current state
-        currentState->draw(window);
+        {
+            ProfileScope scope(ProfilePhase::DRAW);
+
+            // Clear the window with dark background
+            window.clear(sf::Color(20, 20, 20));
+
+            // Draw the top state, over the one beneath if it is an overlay
+            states.draw(window);
+            window.draw(profilerOverlay);
+        }
 
         // Display the window
-        window.display();
+        {
+            ProfileScope scope(ProfilePhase::DISPLAY);
+            window.display();
+        }
+        if (!startupReported && !AssetCache::Instance().isLoading()) {
+            Logger::info("Startup to first complete frame: ", startupClock.getElapsedTime().asMilliseconds(), " ms (",
+                         AssetCache::Instance().isPacked() ? "asset archive" : "loose files", ")");
+            startupReported = true;
+        }
+
+        // Report the render thread's heap allocations in a drawn frame whenever the figure changes
+        if (AllocationCounter::ENABLED) {
+            const uint64_t frameAllocations = AllocationCounter::GetCount() - allocationsBefore;
+            if (frameAllocations != reportedFrameAllocations) {
+                Logger::info("Heap allocations per frame: ", frameAllocations);
+                reportedFrameAllocations = frameAllocations;
+            }
+        }
     }
     
+    if (tracer.isCapturing()) {
+        tracer.stop(tracePath ? tracePath : Tracer::DEFAULT_PATH);
+    }
     Logger::info("Game terminated successfully");
+    Logger::flush();
     return 0;
 } 
\ No newline at end of file